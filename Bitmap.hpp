@@ -0,0 +1,136 @@
+#ifndef BITMAP_HPP
+#define BITMAP_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+//Class that defines a fixed-size set of dense ids stored one bit per id.
+class Bitmap {
+public:
+
+    //Creates an empty bitmap for ids below the given size.
+    explicit Bitmap(size_t size = 0)
+        : size_(size), words_((size + 63) / 64, 0)
+    {
+    }
+
+    //Returns the number of ids the bitmap can hold.
+    size_t size() const
+    {
+        return size_;
+    }
+
+    //Checks if an id is in the set.
+    bool test(size_t i) const
+    {
+        return (words_[i >> 6] >> (i & 63)) & 1;
+    }
+
+    //Adds an id to the set.
+    void set(size_t i)
+    {
+        words_[i >> 6] |= 1ULL << (i & 63);
+    }
+
+    //Removes an id from the set.
+    void reset(size_t i)
+    {
+        words_[i >> 6] &= ~(1ULL << (i & 63));
+    }
+
+    //Removes every id.
+    void clear()
+    {
+        std::memset(words_.data(), 0, words_.size() * sizeof(uint64_t));
+    }
+
+    //Returns the number of ids in the set.
+    size_t count() const
+    {
+        size_t total = 0;
+        for (uint64_t word : words_)
+            total += static_cast<size_t>(__builtin_popcountll(word));
+        return total;
+    }
+
+    //Calls fn(id) for every id in the set, in increasing order.
+    template <typename Function>
+    void for_each(Function fn) const
+    {
+        for (size_t w = 0; w < words_.size(); ++w) {
+            uint64_t word = words_[w];
+            while (word) {
+                fn(w * 64 + static_cast<size_t>(__builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+    }
+
+    //Returns the number of 64-bit words.
+    size_t word_count() const
+    {
+        return words_.size();
+    }
+
+    //Returns the words, bit i of word w standing for id w * 64 + i.
+    uint64_t* words()
+    {
+        return words_.data();
+    }
+
+    const uint64_t* words() const
+    {
+        return words_.data();
+    }
+
+    //Keeps only the ids that are also in the other bitmap. Ids at or past the other bitmap's
+    //size are not in it, so they are removed.
+    Bitmap& operator&=(const Bitmap& other)
+    {
+        const size_t shared = std::min(words_.size(), other.words_.size());
+        for (size_t w = 0; w < shared; ++w)
+            words_[w] &= other.words_[w];
+        std::fill(words_.begin() + shared, words_.end(), 0);
+        return *this;
+    }
+
+    //Adds every id of the other bitmap. Ids at or past this bitmap's size cannot be held and
+    //are left out.
+    Bitmap& operator|=(const Bitmap& other)
+    {
+        const size_t shared = std::min(words_.size(), other.words_.size());
+        for (size_t w = 0; w < shared; ++w)
+            words_[w] |= other.words_[w];
+        if (shared == words_.size() && (size_ & 63) != 0)
+            words_.back() &= (1ULL << (size_ & 63)) - 1;
+        return *this;
+    }
+
+    //Exchanges the contents of two bitmaps.
+    void swap(Bitmap& other)
+    {
+        std::swap(size_, other.size_);
+        words_.swap(other.words_);
+    }
+
+private:
+    size_t size_;                   /**< Number of ids. */
+    std::vector<uint64_t> words_;   /**< One bit per id. */
+};
+
+//Returns the ids in both bitmaps, sized like the first.
+inline Bitmap operator&(Bitmap a, const Bitmap& b) {
+    a &= b;
+    return a;
+}
+
+//Returns the ids in either bitmap that fit in the first.
+inline Bitmap operator|(Bitmap a, const Bitmap& b) {
+    a |= b;
+    return a;
+}
+
+#endif
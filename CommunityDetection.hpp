@@ -0,0 +1,449 @@
+#ifndef COMMUNITY_DETECTION_HPP
+#define COMMUNITY_DETECTION_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "GraphFingerprint.hpp"
+#include "PersonalizedPageRank.hpp"
+#include "ThreadPool.hpp"
+
+// Parallel Louvain community detection. Each level repeatedly moves every
+// vertex to the neighboring community that most increases modularity, then
+// collapses each community into one vertex of a coarser graph, until no
+// vertex moves. Edge strengths come from an affinity of the edge weight, by
+// default the similarity 1 - weight.
+//
+// Moves are decided in parallel: the vertices are split into
+// kLouvainBatches interleaved batches, and every vertex of a batch picks its
+// best community against the assignment left by the previous batch; the
+// moves are then applied together. Two vertices that each sit alone in
+// their community only merge towards the smaller label, so a pair cannot
+// keep swapping. A level ends when a pass over all batches improves
+// modularity by less than kLouvainMinGain. The result does not depend on
+// the thread count.
+
+const size_t kLouvainBatches = 8;
+const double kLouvainMinGain = 1e-6;
+const size_t kLouvainMaxPasses = 32;
+
+// Weighted graph of one Louvain level in CSR form. `loop` holds the weight
+// of the edges collapsed inside each vertex, counted in both directions.
+struct LouvainLevel {
+    std::vector<size_t> offsets;
+    std::vector<uint32_t> targets;
+    std::vector<double> weights;
+    std::vector<double> loop;
+
+    size_t vertex_count() const { return loop.size(); }
+};
+
+// Modularity of a partition of a level graph.
+inline double louvainModularity(const LouvainLevel& level, const std::vector<uint32_t>& community,
+                                size_t communityCount, double resolution = 1.0) {
+    std::vector<double> inside(communityCount, 0.0), total(communityCount, 0.0);
+    double twiceTotalWeight = 0.0;
+    for (size_t v = 0; v < level.vertex_count(); ++v) {
+        double strength = level.loop[v];
+        inside[community[v]] += level.loop[v];
+        for (size_t i = level.offsets[v]; i < level.offsets[v + 1]; ++i) {
+            strength += level.weights[i];
+            if (community[level.targets[i]] == community[v]) inside[community[v]] += level.weights[i];
+        }
+        total[community[v]] += strength;
+        twiceTotalWeight += strength;
+    }
+    if (twiceTotalWeight == 0.0) return 0.0;
+    double q = 0.0;
+    for (size_t c = 0; c < communityCount; ++c) {
+        double share = total[c] / twiceTotalWeight;
+        q += inside[c] / twiceTotalWeight - resolution * share * share;
+    }
+    return q;
+}
+
+// Runs local moving on one level; returns the community of every vertex,
+// renumbered densely, and its count in communityCount.
+inline std::vector<uint32_t> louvainLocalMoving(const LouvainLevel& level, ThreadPool& pool, double resolution,
+                                                size_t& communityCount) {
+    const size_t n = level.vertex_count();
+    std::vector<double> strength(n);
+    double twiceTotalWeight = 0.0;
+    for (size_t v = 0; v < n; ++v) {
+        strength[v] = level.loop[v];
+        for (size_t i = level.offsets[v]; i < level.offsets[v + 1]; ++i) strength[v] += level.weights[i];
+        twiceTotalWeight += strength[v];
+    }
+
+    std::vector<uint32_t> community(n);
+    for (size_t v = 0; v < n; ++v) community[v] = static_cast<uint32_t>(v);
+    std::vector<double> total(strength);
+    std::vector<uint32_t> size(n, 1);
+    std::vector<uint32_t> proposal(n);
+
+    // Per-thread dense accumulators of the weight from a vertex to each community
+    std::vector<std::vector<double>> weightTo(pool.size(), std::vector<double>(n, 0.0));
+    std::vector<std::vector<uint32_t>> touched(pool.size());
+
+    const size_t chunkSize = 1024;
+    double quality = louvainModularity(level, community, n, resolution);
+    for (size_t pass = 0; pass < kLouvainMaxPasses && twiceTotalWeight > 0.0; ++pass) {
+        for (size_t batch = 0; batch < kLouvainBatches; ++batch) {
+            const size_t batchSize = (n + kLouvainBatches - 1 - batch) / kLouvainBatches;
+            pool.parallel_for((batchSize + chunkSize - 1) / chunkSize, [&](size_t chunk, unsigned thread) {
+                auto& weights = weightTo[thread];
+                auto& seen = touched[thread];
+                size_t last = std::min(batchSize, (chunk + 1) * chunkSize);
+                for (size_t j = chunk * chunkSize; j < last; ++j) {
+                    const size_t v = batch + j * kLouvainBatches;
+                    const uint32_t own = community[v];
+                    for (size_t i = level.offsets[v]; i < level.offsets[v + 1]; ++i) {
+                        uint32_t c = community[level.targets[i]];
+                        if (weights[c] == 0.0) seen.push_back(c);
+                        weights[c] += level.weights[i];
+                    }
+
+                    // Gain of joining c after leaving own: weightTo[c] - resolution * k_v * total[c] / 2m
+                    const double scale = resolution * strength[v] / twiceTotalWeight;
+                    uint32_t best = own;
+                    double bestGain = weights[own] - scale * (total[own] - strength[v]);
+                    for (uint32_t c : seen) {
+                        if (c == own) continue;
+                        double gain = weights[c] - scale * total[c];
+                        if (gain > bestGain || (gain == bestGain && c < best)) {
+                            best = c;
+                            bestGain = gain;
+                        }
+                    }
+                    if (best != own && size[own] == 1 && size[best] == 1 && best > own) best = own;
+                    proposal[v] = best;
+
+                    for (uint32_t c : seen) weights[c] = 0.0;
+                    seen.clear();
+                }
+            });
+
+            for (size_t v = batch; v < n; v += kLouvainBatches) {
+                uint32_t from = community[v], to = proposal[v];
+                if (from == to) continue;
+                total[from] -= strength[v];
+                total[to] += strength[v];
+                --size[from];
+                ++size[to];
+                community[v] = to;
+            }
+        }
+
+        double next = louvainModularity(level, community, n, resolution);
+        if (next - quality < kLouvainMinGain) {
+            quality = next;
+            break;
+        }
+        quality = next;
+    }
+
+    // Renumber the communities densely in order of first appearance
+    std::vector<uint32_t> dense(n, UINT32_MAX);
+    communityCount = 0;
+    for (size_t v = 0; v < n; ++v) {
+        if (dense[community[v]] == UINT32_MAX) dense[community[v]] = static_cast<uint32_t>(communityCount++);
+        community[v] = dense[community[v]];
+    }
+    return community;
+}
+
+// Collapses every community of a level into one vertex of the next level.
+inline LouvainLevel louvainAggregate(const LouvainLevel& level, const std::vector<uint32_t>& community,
+                                     size_t communityCount, ThreadPool& pool) {
+    const size_t n = level.vertex_count();
+
+    // Members of every community (counting sort)
+    std::vector<size_t> memberStart(communityCount + 1, 0);
+    for (size_t v = 0; v < n; ++v) ++memberStart[community[v] + 1];
+    for (size_t c = 0; c < communityCount; ++c) memberStart[c + 1] += memberStart[c];
+    std::vector<uint32_t> members(n);
+    std::vector<size_t> fill(memberStart.begin(), memberStart.end() - 1);
+    for (size_t v = 0; v < n; ++v) members[fill[community[v]]++] = static_cast<uint32_t>(v);
+
+    // Edges of every coarse vertex, summed per neighboring community
+    LouvainLevel coarse;
+    coarse.loop.assign(communityCount, 0.0);
+    std::vector<std::vector<std::pair<uint32_t, double>>> edges(communityCount);
+    std::vector<std::vector<double>> weightTo(pool.size(), std::vector<double>(communityCount, 0.0));
+    std::vector<std::vector<uint32_t>> touched(pool.size());
+    pool.parallel_for(communityCount, [&](size_t c, unsigned thread) {
+        auto& weights = weightTo[thread];
+        auto& seen = touched[thread];
+        for (size_t m = memberStart[c]; m < memberStart[c + 1]; ++m) {
+            size_t v = members[m];
+            coarse.loop[c] += level.loop[v];
+            for (size_t i = level.offsets[v]; i < level.offsets[v + 1]; ++i) {
+                uint32_t d = community[level.targets[i]];
+                if (d == c) {
+                    coarse.loop[c] += level.weights[i];
+                    continue;
+                }
+                if (weights[d] == 0.0) seen.push_back(d);
+                weights[d] += level.weights[i];
+            }
+        }
+        std::sort(seen.begin(), seen.end());
+        edges[c].reserve(seen.size());
+        for (uint32_t d : seen) {
+            edges[c].emplace_back(d, weights[d]);
+            weights[d] = 0.0;
+        }
+        seen.clear();
+    });
+
+    coarse.offsets.assign(communityCount + 1, 0);
+    for (size_t c = 0; c < communityCount; ++c) coarse.offsets[c + 1] = coarse.offsets[c] + edges[c].size();
+    coarse.targets.resize(coarse.offsets.back());
+    coarse.weights.resize(coarse.offsets.back());
+    for (size_t c = 0; c < communityCount; ++c) {
+        size_t i = coarse.offsets[c];
+        for (const auto& edge : edges[c]) {
+            coarse.targets[i] = edge.first;
+            coarse.weights[i++] = edge.second;
+        }
+    }
+    return coarse;
+}
+
+// The first level: the graph's edges with their affinities. The graph type
+// needs vertex_count() and adjacent(v) returning (neighbor id, weight)
+// pairs; edges with no positive affinity are left out.
+template <typename GraphType>
+LouvainLevel louvainLevel(const GraphType& graph,
+                          const std::function<double(double)>& affinity = similarityAffinity) {
+    const size_t n = graph.vertex_count();
+    LouvainLevel level;
+    level.loop.assign(n, 0.0);
+    level.offsets.assign(n + 1, 0);
+    for (size_t v = 0; v < n; ++v) {
+        size_t positive = 0;
+        for (const auto& edge : graph.adjacent(v)) {
+            if (edge.first != v && affinity(edge.second) > 0.0) ++positive;
+        }
+        level.offsets[v + 1] = level.offsets[v] + positive;
+    }
+    level.targets.resize(level.offsets[n]);
+    level.weights.resize(level.offsets[n]);
+    for (size_t v = 0; v < n; ++v) {
+        size_t i = level.offsets[v];
+        for (const auto& edge : graph.adjacent(v)) {
+            double a = affinity(edge.second);
+            if (edge.first == v || a <= 0.0) continue;
+            level.targets[i] = static_cast<uint32_t>(edge.first);
+            level.weights[i++] = a;
+        }
+    }
+    return level;
+}
+
+// Community of every vertex of the graph, numbered 0..count-1; 0 threads
+// uses every core. A larger resolution gives more, smaller communities.
+template <typename GraphType>
+std::vector<uint32_t> louvainCommunities(const GraphType& graph, unsigned numThreads = 0,
+                                         const std::function<double(double)>& affinity = similarityAffinity,
+                                         double resolution = 1.0) {
+    const size_t n = graph.vertex_count();
+    LouvainLevel level = louvainLevel(graph, affinity);
+    ThreadPool pool(numThreads);
+    std::vector<uint32_t> result(n);
+    for (size_t v = 0; v < n; ++v) result[v] = static_cast<uint32_t>(v);
+    while (level.vertex_count() > 0) {
+        size_t communityCount = 0;
+        std::vector<uint32_t> community = louvainLocalMoving(level, pool, resolution, communityCount);
+        for (size_t v = 0; v < n; ++v) result[v] = community[result[v]];
+        if (communityCount == level.vertex_count()) break;
+        level = louvainAggregate(level, community, communityCount, pool);
+    }
+    return result;
+}
+
+// On-disk layout of a community index:
+//   CommunityFileHeader
+//   uint32_t community[vertexCount]
+//   uint64_t memberOffsets[communityCount + 1]
+//   uint32_t members[vertexCount]     per community, best first
+
+const char kCommunityFileMagic[8] = { 'M', 'O', 'V', 'C', 'L', 'S', 'T', '2' };
+
+struct CommunityFileHeader {
+    char magic[8];
+    uint64_t vertexCount;
+    uint64_t communityCount;
+    uint64_t entryCount;        // fingerprint of the graph the index was built on
+    uint64_t graphHash;
+};
+
+//Class that defines a precomputed lookup table from every vertex to its community and its community's members.
+//
+//Members of a community are ranked by weighted degree inside the community (the summed affinity
+//of their edges to other members), so the first ones are its most central movies. Looking up a
+//movie's community and reading its top members are O(1) array accesses, with no traversal. The
+//index keeps the fingerprint of the graph it was built on and saves it, so load() turns down an
+//index left over from another graph with the same number of vertices.
+class CommunityIndex {
+public:
+
+    //Range of member ids of one community, best first.
+    struct Members {
+        const uint32_t* first;
+        const uint32_t* last;
+
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+    };
+
+    //Builds the index from a community assignment (e.g. louvainCommunities) of the graph's vertices.
+    template <typename GraphType>
+    void build(const GraphType& graph, std::vector<uint32_t> community,
+               const std::function<double(double)>& affinity = similarityAffinity)
+    {
+        const size_t n = graph.vertex_count();
+        fingerprint_ = graphFingerprint(graph);
+        uint32_t communityCount = 0;
+        for (uint32_t c : community)
+            communityCount = std::max(communityCount, c + 1);
+
+        std::vector<double> inside(n, 0.0);
+        for (size_t v = 0; v < n; ++v) {
+            for (const auto& edge : graph.adjacent(v)) {
+                if (edge.first != v && community[edge.first] == community[v]) inside[v] += std::max(0.0, affinity(edge.second));
+            }
+        }
+
+        offsets_.assign(communityCount + 1, 0);
+        for (uint32_t c : community)
+            ++offsets_[c + 1];
+        for (size_t c = 0; c < communityCount; ++c)
+            offsets_[c + 1] += offsets_[c];
+        members_.resize(n);
+        std::vector<uint64_t> fill(offsets_.begin(), offsets_.end() - 1);
+        for (size_t v = 0; v < n; ++v)
+            members_[fill[community[v]]++] = static_cast<uint32_t>(v);
+        for (size_t c = 0; c < communityCount; ++c) {
+            std::stable_sort(members_.begin() + offsets_[c], members_.begin() + offsets_[c + 1],
+                             [&inside](uint32_t a, uint32_t b) { return inside[a] > inside[b]; });
+        }
+        community_ = std::move(community);
+    }
+
+    //Returns the number of vertices.
+    size_t vertex_count() const
+    {
+        return community_.size();
+    }
+
+    //Returns the number of communities.
+    size_t community_count() const
+    {
+        return offsets_.empty() ? 0 : offsets_.size() - 1;
+    }
+
+    //Returns the community of a vertex.
+    uint32_t community_of(size_t v) const
+    {
+        return community_[v];
+    }
+
+    //Returns the members of a community, best first.
+    Members members(uint32_t c) const
+    {
+        return Members{ members_.data() + offsets_[c], members_.data() + offsets_[c + 1] };
+    }
+
+    //Returns at most k best members of a community.
+    Members top_members(uint32_t c, size_t k) const
+    {
+        Members all = members(c);
+        return Members{ all.first, all.first + std::min(k, all.size()) };
+    }
+
+    //Writes the index to a file; returns false on I/O failure.
+    bool save(const std::string& path) const
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+
+        CommunityFileHeader header;
+        std::memcpy(header.magic, kCommunityFileMagic, sizeof(header.magic));
+        header.vertexCount = community_.size();
+        header.communityCount = community_count();
+        header.entryCount = fingerprint_.entryCount;
+        header.graphHash = fingerprint_.hash;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(community_.data()), community_.size() * sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(offsets_.data()), offsets_.size() * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(members_.data()), members_.size() * sizeof(uint32_t));
+        return static_cast<bool>(file);
+    }
+
+    //Reads an index written by save(); returns false if the file is missing, malformed (including
+    //members that are not each vertex once, in its own community's range), or was built for a
+    //graph whose fingerprint (GraphFingerprint.hpp) differs from this graph's, such as one built
+    //with another threshold or k.
+    template <typename GraphType>
+    bool load(const std::string& path, const GraphType& graph)
+    {
+        const GraphFingerprint fingerprint = graphFingerprint(graph);
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return false;
+
+        CommunityFileHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, kCommunityFileMagic, sizeof(header.magic)) != 0 ||
+            header.vertexCount != fingerprint.vertexCount || header.entryCount != fingerprint.entryCount ||
+            header.graphHash != fingerprint.hash || header.communityCount > header.vertexCount)
+            return false;
+
+        std::vector<uint32_t> community(header.vertexCount);
+        std::vector<uint64_t> offsets(header.communityCount + 1);
+        std::vector<uint32_t> members(header.vertexCount);
+        if (!file.read(reinterpret_cast<char*>(community.data()), community.size() * sizeof(uint32_t)) ||
+            !file.read(reinterpret_cast<char*>(offsets.data()), offsets.size() * sizeof(uint64_t)) ||
+            !file.read(reinterpret_cast<char*>(members.data()), members.size() * sizeof(uint32_t)))
+            return false;
+        if (offsets.front() != 0 || offsets.back() != header.vertexCount ||
+            !std::is_sorted(offsets.begin(), offsets.end()))
+            return false;
+        for (uint32_t c : community) {
+            if (c >= header.communityCount) return false;
+        }
+
+        // members must list every vertex once, inside the range of its own community
+        std::vector<char> listed(header.vertexCount, 0);
+        for (uint64_t c = 0; c < header.communityCount; ++c) {
+            for (uint64_t i = offsets[c]; i < offsets[c + 1]; ++i) {
+                uint32_t v = members[i];
+                if (v >= header.vertexCount || listed[v] || community[v] != c) return false;
+                listed[v] = 1;
+            }
+        }
+
+        community_ = std::move(community);
+        offsets_ = std::move(offsets);
+        members_ = std::move(members);
+        fingerprint_ = fingerprint;
+        return true;
+    }
+
+private:
+    std::vector<uint32_t> community_;   /**< Community of every vertex. */
+    std::vector<uint64_t> offsets_;     /**< Start of every community in members_. */
+    std::vector<uint32_t> members_;     /**< Members grouped by community, best first. */
+    GraphFingerprint fingerprint_;      /**< Fingerprint of the graph the index was built on. */
+};
+
+#endif
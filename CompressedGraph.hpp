@@ -0,0 +1,293 @@
+#ifndef COMPRESSED_GRAPH_HPP
+#define COMPRESSED_GRAPH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+#include "TraversalContext.hpp"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Neighbor lists in Stream VByte form: each list's ids are sorted and
+// replaced by the gaps between consecutive ids (the first by itself), and
+// each gap is stored in 1 to 4 little-endian bytes. The byte lengths of four
+// gaps are packed into one control byte (2 bits each, first gap in the low
+// bits), and a list's control bytes come right before its data bytes:
+//
+//     [control bytes: ceil(degree / 4)][gap bytes: 1..4 per neighbor]
+//
+// Keeping the lengths apart from the data lets a decoder expand four gaps
+// with one byte shuffle (SSSE3 pshufb or NEON tbl) driven by a table indexed
+// by the control byte, then turn them back into ids with a prefix sum.
+// Targets without a byte shuffle decode one gap at a time.
+
+//Returns the number of bytes Stream VByte uses for a value.
+inline size_t streamVByteLength(uint32_t value) {
+    return value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : value < (1u << 24) ? 3 : 4;
+}
+
+//Appends the gap encoding of sorted ids (control bytes, then data bytes) to out.
+inline void streamVByteEncode(const uint32_t* ids, size_t count, std::vector<uint8_t>& out) {
+    size_t control = out.size();
+    out.resize(out.size() + (count + 3) / 4, 0);
+    uint32_t previous = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t gap = ids[i] - previous;
+        previous = ids[i];
+        size_t length = streamVByteLength(gap);
+        out[control + i / 4] |= static_cast<uint8_t>((length - 1) << (2 * (i % 4)));
+        for (size_t b = 0; b < length; ++b)
+            out.push_back(static_cast<uint8_t>(gap >> (8 * b)));
+    }
+}
+
+//Shuffle masks and data lengths of every control byte.
+struct StreamVByteTables {
+    std::array<std::array<uint8_t, 16>, 256> shuffle;
+    std::array<uint8_t, 256> length;
+
+    StreamVByteTables()
+    {
+        for (size_t control = 0; control < 256; ++control) {
+            size_t source = 0;
+            for (size_t lane = 0; lane < 4; ++lane) {
+                size_t bytes = ((control >> (2 * lane)) & 3) + 1;
+                for (size_t b = 0; b < 4; ++b)
+                    shuffle[control][4 * lane + b] = b < bytes ? static_cast<uint8_t>(source + b) : 0xFF;
+                source += bytes;
+            }
+            length[control] = static_cast<uint8_t>(source);
+        }
+    }
+};
+
+inline const StreamVByteTables& streamVByteTables() {
+    static const StreamVByteTables tables;
+    return tables;
+}
+
+//Decodes `count` ids encoded by streamVByteEncode at `in` into out. Reads
+//run up to 16 bytes past a group's data, so the buffer needs 15 bytes of
+//padding after the last list.
+inline void streamVByteDecode(const uint8_t* in, size_t count, uint32_t* out) {
+    const uint8_t* control = in;
+    const uint8_t* data = in + (count + 3) / 4;
+    size_t i = 0;
+    uint32_t previous = 0;
+
+#if defined(__SSSE3__) || (defined(__aarch64__) && defined(__ARM_NEON))
+    const StreamVByteTables& tables = streamVByteTables();
+#endif
+#if defined(__SSSE3__)
+    __m128i base = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        uint8_t c = *control++;
+        __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.shuffle[c].data()));
+        __m128i gaps = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), mask);
+        data += tables.length[c];
+        // Prefix sum of the four gaps, then add the last id of the previous group
+        gaps = _mm_add_epi32(gaps, _mm_slli_si128(gaps, 4));
+        gaps = _mm_add_epi32(gaps, _mm_slli_si128(gaps, 8));
+        base = _mm_add_epi32(gaps, base);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), base);
+        base = _mm_shuffle_epi32(base, 0xFF);
+    }
+    if (i > 0)
+        previous = out[i - 1];
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    const uint32x4_t zero = vdupq_n_u32(0);
+    uint32x4_t base = zero;
+    for (; i + 4 <= count; i += 4) {
+        uint8_t c = *control++;
+        uint8x16_t mask = vld1q_u8(tables.shuffle[c].data());
+        uint32x4_t gaps = vreinterpretq_u32_u8(vqtbl1q_u8(vld1q_u8(data), mask));
+        data += tables.length[c];
+        gaps = vaddq_u32(gaps, vextq_u32(zero, gaps, 3));
+        gaps = vaddq_u32(gaps, vextq_u32(zero, gaps, 2));
+        base = vaddq_u32(gaps, base);
+        vst1q_u32(out + i, base);
+        base = vdupq_laneq_u32(base, 3);
+    }
+    if (i > 0)
+        previous = out[i - 1];
+#endif
+
+    for (; i < count; ++i) {
+        size_t bytes = ((control[0] >> (2 * (i % 4))) & 3) + 1;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        // One unaligned load, masked to the gap's length (the padding keeps it in bounds)
+        static const uint32_t keep[4] = { 0xFF, 0xFFFF, 0xFFFFFF, 0xFFFFFFFF };
+        uint32_t gap;
+        std::memcpy(&gap, data, sizeof(gap));
+        gap &= keep[bytes - 1];
+#else
+        uint32_t gap = 0;
+        for (size_t b = 0; b < bytes; ++b)
+            gap |= static_cast<uint32_t>(data[b]) << (8 * b);
+#endif
+        data += bytes;
+        previous += gap;
+        out[i] = previous;
+        if (i % 4 == 3)
+            ++control;
+    }
+}
+
+//Class that defines a read-only weighted graph with Stream VByte neighbor lists and 8-bit weights.
+//
+//Each vertex's neighbors are sorted by id and gap-encoded (see streamVByteDecode above); each
+//neighbor's weight is an 8-bit code in the same order. When the graph has at most 256 distinct
+//weights (a similarity graph has a handful) the codes index a table of the exact values;
+//otherwise code q stands for weightMin + q / 255 * (weightMax - weightMin). A similarity graph
+//takes about 2.3 bytes per adjacency entry instead of Graph's 16.
+//
+//Lists are decoded on the fly: bfs() decodes each expanded vertex's list into a reused buffer.
+//adjacent(v) decodes into a new vector of (neighbor id, weight) pairs, so the generic
+//algorithms run on this graph too, at the cost of an allocation per call.
+class CompressedGraph {
+public:
+
+    //Encodes a graph; the graph type needs vertex_count() and adjacent(v) returning (neighbor id, weight) pairs.
+    template <typename GraphType>
+    explicit CompressedGraph(const GraphType& graph)
+    {
+        const size_t n = graph.vertex_count();
+        std::map<double, uint8_t> codebook;
+        double lowest = std::numeric_limits<double>::infinity();
+        double highest = -std::numeric_limits<double>::infinity();
+        for (size_t v = 0; v < n; ++v) {
+            for (const auto& edge : graph.adjacent(v)) {
+                lowest = std::min(lowest, edge.second);
+                highest = std::max(highest, edge.second);
+                if (codebook.size() <= 256)
+                    codebook.emplace(edge.second, 0);
+            }
+        }
+        const bool exact = codebook.size() <= 256;
+        if (exact) {
+            for (auto& entry : codebook) {
+                entry.second = static_cast<uint8_t>(weightTable_.size());
+                weightTable_.push_back(entry.first);
+            }
+        } else {
+            for (size_t q = 0; q < 256; ++q)
+                weightTable_.push_back(lowest + q / 255.0 * (highest - lowest));
+        }
+        auto code = [&](double w) -> uint8_t {
+            if (exact)
+                return codebook.at(w);
+            return highest == lowest ? 0 : static_cast<uint8_t>((w - lowest) / (highest - lowest) * 255.0 + 0.5);
+        };
+
+        entryOffsets_.assign(n + 1, 0);
+        dataOffsets_.assign(n + 1, 0);
+        std::vector<std::pair<uint32_t, uint8_t>> list;
+        std::vector<uint32_t> ids;
+        for (size_t v = 0; v < n; ++v) {
+            list.clear();
+            for (const auto& edge : graph.adjacent(v))
+                list.emplace_back(static_cast<uint32_t>(edge.first), code(edge.second));
+            std::sort(list.begin(), list.end());
+            ids.clear();
+            for (const auto& entry : list) {
+                ids.push_back(entry.first);
+                weightCodes_.push_back(entry.second);
+            }
+            streamVByteEncode(ids.data(), ids.size(), data_);
+            entryOffsets_[v + 1] = entryOffsets_[v] + list.size();
+            dataOffsets_[v + 1] = data_.size();
+        }
+        data_.resize(data_.size() + 15, 0);
+        data_.shrink_to_fit();
+        weightCodes_.shrink_to_fit();
+    }
+
+    //Returns the number of vertices.
+    size_t vertex_count() const
+    {
+        return entryOffsets_.size() - 1;
+    }
+
+    //Returns the number of neighbors of a vertex.
+    size_t degree(size_t v) const
+    {
+        return entryOffsets_[v + 1] - entryOffsets_[v];
+    }
+
+    //Writes the neighbor ids of a vertex, ascending, to out (room for degree(v) ids).
+    void decode_neighbors(size_t v, uint32_t* out) const
+    {
+        streamVByteDecode(data_.data() + dataOffsets_[v], degree(v), out);
+    }
+
+    //Returns the weight of the i-th neighbor of a vertex.
+    double weight(size_t v, size_t i) const
+    {
+        return weightTable_[weightCodes_[entryOffsets_[v] + i]];
+    }
+
+    //Returns the (neighbor id, weight) pairs of a vertex, ascending by id.
+    std::vector<std::pair<size_t, double>> adjacent(size_t v) const
+    {
+        std::vector<uint32_t> ids(degree(v));
+        decode_neighbors(v, ids.data());
+        std::vector<std::pair<size_t, double>> result(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i)
+            result[i] = { ids[i], weight(v, i) };
+        return result;
+    }
+
+    //Appends the vertices reachable from the source in breadth-first order (neighbors in
+    //ascending id order) to `order`. Allocation-free once the context and buffers have grown.
+    void bfs(size_t source, TraversalContext& context, std::vector<size_t>& order) const
+    {
+        if (source >= vertex_count())
+            return;
+        thread_local std::vector<uint32_t> decoded;
+        context.reset(vertex_count());
+        auto& queue = context.pending();
+        context.visit(source);
+        queue.push_back(static_cast<uint32_t>(source));
+        for (size_t head = 0; head < queue.size(); ++head) {
+            size_t current = queue[head];
+            order.push_back(current);
+            size_t d = degree(current);
+            if (decoded.size() < d)
+                decoded.resize(d);
+            decode_neighbors(current, decoded.data());
+            for (size_t i = 0; i < d; ++i) {
+                uint32_t u = decoded[i];
+                if (!context.visited(u)) {
+                    context.visit(u);
+                    queue.push_back(u);
+                }
+            }
+        }
+    }
+
+    //Returns the number of bytes used by the encoded graph.
+    size_t memory_bytes() const
+    {
+        return data_.size() + weightCodes_.size() + (entryOffsets_.size() + dataOffsets_.size()) * sizeof(uint64_t) +
+               weightTable_.size() * sizeof(double);
+    }
+
+private:
+    std::vector<uint64_t> entryOffsets_;    /**< First adjacency entry of every vertex. */
+    std::vector<uint64_t> dataOffsets_;     /**< Start of every vertex's control and gap bytes. */
+    std::vector<uint8_t> data_;             /**< Encoded neighbor lists, plus 15 bytes of padding. */
+    std::vector<uint8_t> weightCodes_;      /**< Weight code of every adjacency entry. */
+    std::vector<double> weightTable_;       /**< Weight of every code. */
+};
+
+#endif
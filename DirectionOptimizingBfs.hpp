@@ -0,0 +1,88 @@
+#ifndef DIRECTION_OPTIMIZING_BFS_HPP
+#define DIRECTION_OPTIMIZING_BFS_HPP
+
+#include <vector>
+#include "Bitmap.hpp"
+
+// Breadth-first search over dense vertex ids that switches direction per
+// level (Beamer, Asanovic and Patterson). The graph type needs
+// vertex_count() and adjacent(v) returning a range of (neighbor id, weight)
+// pairs.
+//
+// Top-down steps scan the edges of every frontier vertex. Bottom-up steps
+// scan the unvisited vertices instead and stop at the first neighbor found
+// in the frontier. Once the frontier reaches most of the graph, this touches
+// a small fraction of the edges. The search goes bottom-up when the
+// frontier's edges outnumber the unvisited vertices' edges / alpha, and
+// back top-down when the frontier shrinks below n / beta vertices. Frontier
+// and visited sets are bitmaps.
+//
+// Returns the reachable vertices level by level, in increasing id order
+// within a level. That is the same set, with the same levels, as a
+// queue-based BFS; only the order inside a level may differ.
+
+const size_t kBfsAlpha = 14;
+const size_t kBfsBeta = 24;
+
+template <typename GraphType>
+std::vector<size_t> directionOptimizingBfs(const GraphType& graph, size_t source) {
+    const size_t n = graph.vertex_count();
+    std::vector<size_t> order;
+    if (source >= n) return order;
+
+    Bitmap visited(n), frontier(n), next(n);
+    visited.set(source);
+    frontier.set(source);
+    order.push_back(source);
+
+    size_t frontierSize = 1;
+    size_t frontierEdges = graph.adjacent(source).size();
+    size_t unvisitedEdges = 0;
+    for (size_t v = 0; v < n; ++v) unvisitedEdges += graph.adjacent(v).size();
+    unvisitedEdges -= frontierEdges;
+
+    bool bottomUp = false;
+    while (frontierSize > 0) {
+        if (!bottomUp && frontierEdges > unvisitedEdges / kBfsAlpha) {
+            bottomUp = true;
+        } else if (bottomUp && frontierSize < n / kBfsBeta) {
+            bottomUp = false;
+        }
+
+        next.clear();
+        if (bottomUp) {
+            for (size_t v = 0; v < n; ++v) {
+                if (visited.test(v)) continue;
+                for (const auto& edge : graph.adjacent(v)) {
+                    if (frontier.test(edge.first)) {
+                        visited.set(v);
+                        next.set(v);
+                        break;
+                    }
+                }
+            }
+        } else {
+            frontier.for_each([&](size_t u) {
+                for (const auto& edge : graph.adjacent(u)) {
+                    if (!visited.test(edge.first)) {
+                        visited.set(edge.first);
+                        next.set(edge.first);
+                    }
+                }
+            });
+        }
+
+        frontierSize = 0;
+        frontierEdges = 0;
+        next.for_each([&](size_t v) {
+            order.push_back(v);
+            ++frontierSize;
+            frontierEdges += graph.adjacent(v).size();
+        });
+        unvisitedEdges -= frontierEdges;
+        frontier.swap(next);
+    }
+    return order;
+}
+
+#endif
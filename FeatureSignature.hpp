@@ -0,0 +1,51 @@
+#ifndef FEATURE_SIGNATURE_HPP
+#define FEATURE_SIGNATURE_HPP
+
+#include <bitset>
+#include <cstddef>
+#include <functional>
+#include "Movie.hpp"
+
+// The features calculateSimilarity looks at: release year and platform flags.
+// Movies with equal signatures are indistinguishable to the similarity
+// function, so anything that only depends on similarity can work per
+// signature class instead of per movie.
+struct FeatureSignature {
+    int year;
+    unsigned platforms;
+
+    FeatureSignature() : year(0), platforms(0) {}
+
+    FeatureSignature(int year, unsigned platforms) : year(year), platforms(platforms) {}
+
+    explicit FeatureSignature(const Movie& movie)
+        : year(movie.getYear()), platforms(movie.getPlatformMask()) {}
+
+    bool operator==(const FeatureSignature& other) const {
+        return year == other.year && platforms == other.platforms;
+    }
+
+    bool operator!=(const FeatureSignature& other) const {
+        return !(*this == other);
+    }
+};
+
+struct FeatureSignatureHash {
+    size_t operator()(const FeatureSignature& s) const {
+        return std::hash<long long>()((static_cast<long long>(s.year) << 4) | s.platforms);
+    }
+};
+
+// Number of matching features (0..5) between two signatures
+int signatureMatches(const FeatureSignature& a, const FeatureSignature& b) {
+    int matches = (a.year == b.year) ? 1 : 0;
+    matches += 4 - static_cast<int>(std::bitset<4>((a.platforms ^ b.platforms) & 0xFu).count());
+    return matches;
+}
+
+// Same value calculateSimilarity returns for any two movies carrying these signatures
+double signatureSimilarity(const FeatureSignature& a, const FeatureSignature& b) {
+    return signatureMatches(a, b) / 5.0;
+}
+
+#endif
@@ -1,8 +1,11 @@
-﻿#include <iostream>
+﻿#include <algorithm>
+#include <iostream>
+#include <string>
 #include <vector>
 #include <unordered_map>
 #include <queue>
 #include <stack>
+#include "ParallelTraversal.hpp"
 
 //Structure that defines an edge in a graph.
 struct edge {
@@ -25,6 +28,10 @@ public:
         vertices_.clear();
         edges_.clear();
         mapping_.clear();
+        adjacency_.clear();
+        mirror_.clear();
+        edgeIndex_.clear();
+        removalsSinceCompaction_ = 0;
     }
     //Returns the vector with the vertices of the graph.
     const std::vector<std::string>& vertices() const 
@@ -58,32 +65,56 @@ public:
 
         // Add the vertex to the mapping.
         mapping_[v] = vertices_.size() - 1;
+
+        // Add an empty adjacency list for the vertex.
+        adjacency_.emplace_back();
+        mirror_.emplace_back();
     }
 
-    //Removes the specified vertex from the graph.
+    //Removes the specified vertex from the graph in O(degree): the last vertex moves into its index.
     void remove_vertex(const std::string& v)
     {
         // Check if the vertex exists
-        if (mapping_.find(v) == mapping_.end()) {
+        auto it = mapping_.find(v);
+        if (it == mapping_.end()) {
             std::cout << "Vertex with the id does not exist" << std::endl;
             return;
         }
-
-        // Remove the vertex from the mapping.
-        mapping_.erase(v);
-
-        // Remove the vertex from the collection of vertices.                
-        auto new_vertices_end = std::remove(vertices_.begin(), vertices_.end(), v);
-        vertices_.erase(new_vertices_end, vertices_.end());
+        size_t index = it->second;
 
         // Remove the edges that contain the vertex.
-        auto new_edges_end = std::remove_if(edges_.begin(), edges_.end(),
-            [&v](const edge& edge) {
-                return edge.v1 == v || edge.v2 == v;
-            });
-
-        edges_.erase(new_edges_end, edges_.end());
+        for (size_t i = 0; i < adjacency_[index].size(); ++i) {
+            size_t neighbor = adjacency_[index][i].first;
+            unlink(neighbor, mirror_[index][i]);
+            erase_edge(edge_key(index, neighbor));
+        }
+        adjacency_[index].clear();
+        mirror_[index].clear();
+
+        // Move the last vertex into the freed index.
+        size_t last = vertices_.size() - 1;
+        if (index != last) {
+            for (size_t i = 0; i < adjacency_[last].size(); ++i) {
+                size_t neighbor = adjacency_[last][i].first;
+                adjacency_[neighbor][mirror_[last][i]].first = index;
+
+                auto key = edgeIndex_.find(edge_key(last, neighbor));
+                size_t position = key->second;
+                edgeIndex_.erase(key);
+                edgeIndex_[edge_key(index, neighbor)] = position;
+            }
+            vertices_[index] = std::move(vertices_[last]);
+            adjacency_[index].swap(adjacency_[last]);
+            mirror_[index].swap(mirror_[last]);
+            mapping_[vertices_[index]] = index;
+        }
 
+        // Remove the vertex from the mapping and the collection of vertices.
+        mapping_.erase(it);
+        vertices_.pop_back();
+        adjacency_.pop_back();
+        mirror_.pop_back();
+        note_removal();
     }
 
     //Checks if the graph contains the specified vertex.
@@ -115,6 +146,7 @@ public:
 
         // Add the edge to the collection of edges.
         edges_.push_back({ v1, v2 });
+        index_edge(edges_.back());
     }
 
     //Adds a new edge to the graph.
@@ -140,9 +172,10 @@ public:
 
         // Add the edge to the collection of edges.
         edges_.push_back({ v1, v2, weight});
+        index_edge(edges_.back());
     }
 
-    //Removes the specified edge from the graph.
+    //Removes the specified edge from the graph in O(degree).
     void remove_edge(const std::string& v1, const std::string& v2)
     {
         // Check if the edge exists
@@ -151,24 +184,29 @@ public:
             return;
         }
 
-        // Remove the edge from the collection of edges.
-        auto new_edges_end = std::remove_if(edges_.begin(), edges_.end(),
-            [&v1, &v2](const edge& edge) {
-                return (edge.v1 == v1 && edge.v2 == v2) || (edge.v1 == v2 && edge.v2 == v1);
-            });
+        // Unlink the vertices from each other's adjacency lists.
+        size_t p1 = mapping_.at(v1);
+        size_t p2 = mapping_.at(v2);
+        size_t i = 0;
+        while (adjacency_[p1][i].first != p2)
+            ++i;
+        unlink(p2, mirror_[p1][i]);
+        unlink(p1, i);
 
-        edges_.erase(new_edges_end, edges_.end());
+        // Remove the edge from the collection of edges.
+        erase_edge(edge_key(p1, p2));
+        note_removal();
     }
 
     //Checks if the graph contains the specified edge.
     bool contains_edge(const std::string& v1, const std::string& v2) const
     {
-        for (const auto& ei : edges_) {
-            if ((ei.v1 == v1 && ei.v2 == v2) || (ei.v1 == v2 && ei.v2 == v1))
-                return true;
-        }
+        auto it1 = mapping_.find(v1);
+        auto it2 = mapping_.find(v2);
+        if (it1 == mapping_.end() || it2 == mapping_.end())
+            return false;
 
-        return false;
+        return edgeIndex_.count(edge_key(it1->second, it2->second)) != 0;
     }
 
     //Returns the neighbors of the specified vertex.
@@ -176,12 +214,13 @@ public:
     {   
         std::vector<std::string> result;
 
-        for (const auto& e : edges_) {
-            if (e.v1 == v)
-                result.push_back(vertices_[mapping_.at(e.v2)]);
-            else if (e.v2 == v)
-                result.push_back(vertices_[mapping_.at(e.v1)]);
-        }
+        auto it = mapping_.find(v);
+        if (it == mapping_.end())
+            return result;
+
+        result.reserve(adjacency_[it->second].size());
+        for (const auto& neighbor : adjacency_[it->second])
+            result.push_back(vertices_[neighbor.first]);
 
         return result;
     }
@@ -189,7 +228,8 @@ public:
     //Returns the degree of the specified vertex.
     unsigned long long degree(const std::string& v) const
     {
-        return neighbors(v).size();
+        auto it = mapping_.find(v);
+        return it == mapping_.end() ? 0 : adjacency_[it->second].size();
     }
 
     //Traverses the vertices of the graph starting from the specified vertex using a breadth-first search (BFS) algorithm.
@@ -227,18 +267,13 @@ public:
             size_t currentIndex = mapping_.at(current);
             visited.push_back(vertices_[currentIndex]);
 
-            for (const auto& neighbor : neighbors(current)) {
-
-                auto it = mapping_.find(neighbor);
-                if (it != mapping_.end()) {
-
-                    size_t neighborIndex = it->second;
+            for (const auto& neighbor : adjacency_[currentIndex]) {
 
-                    if (!explored[neighborIndex]) {
-                        frontier.push(neighbor);
-                        explored[neighborIndex] = true;
-                    }
+                size_t neighborIndex = neighbor.first;
 
+                if (!explored[neighborIndex]) {
+                    frontier.push(vertices_[neighborIndex]);
+                    explored[neighborIndex] = true;
                 }
             }
         }
@@ -281,19 +316,13 @@ public:
             size_t currentIndex = mapping_.at(current);
             visited.push_back(vertices_[currentIndex]);
 
-            for (const auto& neighborId : neighbors(current)) {
+            for (const auto& neighbor : adjacency_[currentIndex]) {
 
-                auto it = mapping_.find(neighborId);
-
-                if (it != mapping_.end()) {
-
-                    size_t neighborIndex = it->second;
-
-                    if (!explored[neighborIndex]) {
-                        frontier.push(neighborId);
-                        explored[neighborIndex] = true;
-                    }
+                size_t neighborIndex = neighbor.first;
 
+                if (!explored[neighborIndex]) {
+                    frontier.push(vertices_[neighborIndex]);
+                    explored[neighborIndex] = true;
                 }
             }
         }
@@ -335,18 +364,13 @@ public:
             size_t currentIndex = mapping_.at(current);
             std::cout << vertices_[currentIndex] << " ";
 
-            for (const auto& neighbor : neighbors(current)) {
-
-                auto it = mapping_.find(neighbor);
-                if (it != mapping_.end()) {
-                    
-                    size_t neighborIndex = it->second;
+            for (const auto& neighbor : adjacency_[currentIndex]) {
 
-                    if (!explored[neighborIndex]) {
-                        frontier.push(neighbor);
-                        explored[neighborIndex] = true;
-                    }
+                size_t neighborIndex = neighbor.first;
 
+                if (!explored[neighborIndex]) {
+                    frontier.push(vertices_[neighborIndex]);
+                    explored[neighborIndex] = true;
                 }
             }
         }
@@ -388,19 +412,13 @@ public:
             size_t currentIndex = mapping_.at(current);
             std::cout << vertices_[currentIndex] << " ";
 
-            for (const auto& neighborId : neighbors(current)) {
+            for (const auto& neighbor : adjacency_[currentIndex]) {
 
-                auto it = mapping_.find(neighborId);
-                
-                if (it != mapping_.end()) {
-
-                    size_t neighborIndex = it->second;
-
-                    if (!explored[neighborIndex]) {
-                        frontier.push(neighborId);
-                        explored[neighborIndex] = true;
-                    }
+                size_t neighborIndex = neighbor.first;
 
+                if (!explored[neighborIndex]) {
+                    frontier.push(vertices_[neighborIndex]);
+                    explored[neighborIndex] = true;
                 }
             }
         }
@@ -455,20 +473,14 @@ public:
             }
 
             // Explore the neighbors of the current vertex
-            for (const auto& neighbor : neighbors(current)) {
-
-                auto it = mapping_.find(neighbor);
-
-                if (it != mapping_.end()) {
+            for (const auto& neighbor : adjacency_[mapping_.at(current)]) {
 
-                    size_t neighborIndex = it->second; 
-                    
-                    if (!explored[neighborIndex]) {
-                        frontier.push(neighbor);
-                        explored[neighborIndex] = true;
-                        parents[neighbor] = current;
-                    }
+                size_t neighborIndex = neighbor.first;
 
+                if (!explored[neighborIndex]) {
+                    frontier.push(vertices_[neighborIndex]);
+                    explored[neighborIndex] = true;
+                    parents[vertices_[neighborIndex]] = current;
                 }
             }
         }
@@ -523,20 +535,14 @@ public:
             }
 
             // Explore the neighbors of the current vertex
-            for (const auto& neighbor : neighbors(current)) {
+            for (const auto& neighbor : adjacency_[mapping_.at(current)]) {
 
-                auto it = mapping_.find(neighbor);
-                
-                if (it != mapping_.end()) {
-
-                    size_t neighborIndex = it->second;
-
-                    if (!explored[neighborIndex]) {
-                        frontier.push(neighbor);
-                        explored[neighborIndex] = true;
-                        parents[neighbor] = current;
-                    }
+                size_t neighborIndex = neighbor.first;
 
+                if (!explored[neighborIndex]) {
+                    frontier.push(vertices_[neighborIndex]);
+                    explored[neighborIndex] = true;
+                    parents[vertices_[neighborIndex]] = current;
                 }
             }
         }
@@ -544,9 +550,133 @@ public:
         return path;
     }
 
+    //Traverses the vertices reachable from the specified vertex with a multi-threaded, level-synchronous BFS.
+    //Vertices come level by level, in the order of `vertices_` within a level (0 threads uses every core).
+    std::vector<std::string> bfs_parallel(const std::string& start, unsigned numThreads = 0) const
+    {
+        std::vector<std::string> visited;
+
+        // Check if the graph is empty
+        if (vertices_.empty()) {
+            std::cout << "Graph is empty" << std::endl;
+            return visited;
+        }
+
+        // Check if the vertex exists
+        if (!contains_vertex(start)) {
+            std::cout << "Vertex with the id does not exists" << std::endl;
+            return visited;
+        }
+
+        // Run the parallel traversal over the adjacency index
+        size_t source = mapping_.at(start);
+        ThreadPool pool(numThreads);
+
+        for (size_t v : parallelBfs(AdjacencyListView{ adjacency_ }, source, pool))
+            visited.push_back(vertices_[v]);
+
+        return visited;
+    }
+
+    //Returns the connected components of the graph, computed with a multi-threaded union-find.
+    //Each component lists its vertices in the order of `vertices_` (0 threads uses every core).
+    std::vector<std::vector<std::string>> connected_components(unsigned numThreads = 0) const
+    {
+        ThreadPool pool(numThreads);
+        std::vector<size_t> label = parallelConnectedComponents(AdjacencyListView{ adjacency_ }, pool);
+
+        // A label is the position of the first vertex of its component
+        std::vector<std::vector<std::string>> components;
+        std::vector<size_t> componentOf(vertices_.size());
+        for (size_t v = 0; v < vertices_.size(); ++v) {
+            if (label[v] == v) {
+                componentOf[v] = components.size();
+                components.emplace_back();
+            }
+            components[componentOf[label[v]]].push_back(vertices_[v]);
+        }
+
+        return components;
+    }
+
+    //Shrinks the storage left over by removals to fit the graph. Runs on its own every max(1024, V / 2) removals.
+    void compact()
+    {
+        vertices_.shrink_to_fit();
+        edges_.shrink_to_fit();
+        adjacency_.shrink_to_fit();
+        mirror_.shrink_to_fit();
+        for (size_t v = 0; v < adjacency_.size(); ++v) {
+            adjacency_[v].shrink_to_fit();
+            mirror_[v].shrink_to_fit();
+        }
+        mapping_.rehash(0);
+        edgeIndex_.rehash(0);
+        removalsSinceCompaction_ = 0;
+    }
+
 private:
 
+    //Returns the key of the edge between two vertex positions in `edgeIndex_`, the same in both directions.
+    static unsigned long long edge_key(size_t p1, size_t p2)
+    {
+        if (p1 > p2)
+            std::swap(p1, p2);
+        return (static_cast<unsigned long long>(p1) << 32) | p2;
+    }
+
+    //Adds the last edge of `edges_` to the adjacency index.
+    void index_edge(const edge& e)
+    {
+        size_t p1 = mapping_.at(e.v1);
+        size_t p2 = mapping_.at(e.v2);
+        adjacency_[p1].emplace_back(p2, e.weight);
+        adjacency_[p2].emplace_back(p1, e.weight);
+        mirror_[p1].push_back(adjacency_[p2].size() - 1);
+        mirror_[p2].push_back(adjacency_[p1].size() - 1);
+        edgeIndex_[edge_key(p1, p2)] = edges_.size() - 1;
+    }
+
+    //Removes the i-th entry of an adjacency list by moving the last entry into its place.
+    void unlink(size_t from, size_t i)
+    {
+        size_t last = adjacency_[from].size() - 1;
+        if (i != last) {
+            adjacency_[from][i] = adjacency_[from][last];
+            mirror_[from][i] = mirror_[from][last];
+            mirror_[adjacency_[from][i].first][mirror_[from][i]] = i;
+        }
+        adjacency_[from].pop_back();
+        mirror_[from].pop_back();
+    }
+
+    //Removes an edge from `edges_` by moving the last edge into its place.
+    void erase_edge(unsigned long long key)
+    {
+        auto it = edgeIndex_.find(key);
+        size_t position = it->second;
+        edgeIndex_.erase(it);
+
+        if (position != edges_.size() - 1) {
+            edges_[position] = std::move(edges_.back());
+            const edge& moved = edges_[position];
+            edgeIndex_[edge_key(mapping_.at(moved.v1), mapping_.at(moved.v2))] = position;
+        }
+        edges_.pop_back();
+    }
+
+    //Counts a removal, compacting the storage once enough have accumulated.
+    void note_removal()
+    {
+        if (++removalsSinceCompaction_ >= std::max<size_t>(1024, vertices_.size() / 2))
+            compact();
+    }
+
     std::vector<std::string> vertices_;                             /**< The vertices of the graph. */
     std::vector<edge> edges_;                                       /**< The edges of the graph. */
     std::unordered_map<std::string, unsigned long long> mapping_;   /**< Mapping from vertex Ids to indices in `vertices_`. */
+    std::vector<std::vector<std::pair<size_t, double>>> adjacency_; /**< (neighbor index, weight) of every vertex. */
+    std::vector<std::vector<size_t>> mirror_;                       /**< mirror_[v][i]: index of v's entry in the list of its i-th neighbor. */
+    std::unordered_map<unsigned long long, size_t> edgeIndex_;      /**< edge_key() of every edge -> its index in `edges_`. */
+    size_t removalsSinceCompaction_ = 0;                            /**< Removals since the last compact(). */
 };
@@ -0,0 +1,168 @@
+#ifndef GRAPH_FILE_HPP
+#define GRAPH_FILE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// On-disk layout of a weighted graph, designed to be used in place after mmap.
+//
+//   GraphFileHeader
+//   uint64_t titleOffsets[vertexCount + 1]   byte range of every title in the heap
+//   char     titleHeap[...]                  titles, back to back, no terminators
+//   uint32_t titleOrder[vertexCount]         vertex ids sorted by title (for lookup)
+//   uint64_t adjacencyOffsets[vertexCount + 1]
+//   uint32_t neighbors[entryCount]           neighbor ids, list by list
+//   uint16_t weights[entryCount]             quantized weights
+//   double   weightTable[weightTableSize]    weight of every code (codebook mode only)
+//
+// Weights are stored as 16-bit codes. When the graph has at most 65536
+// distinct weights (a similarity graph has a handful) the codes index a
+// table of the exact values; otherwise code q stands for
+// weightMin + q / 65535 * (weightMax - weightMin).
+//
+// Every section starts on an 8-byte boundary and the position of each one is
+// stored in the header. Integers use the byte order of the machine that wrote
+// the file. An undirected edge appears in both endpoint lists, so entryCount
+// is twice the number of edges.
+
+const char kGraphFileMagic[8] = { 'M', 'O', 'V', 'G', 'R', 'P', 'H', '1' };
+const uint32_t kGraphFileVersion = 1;
+
+struct GraphFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t weightBits;
+    uint64_t vertexCount;
+    uint64_t entryCount;
+    double weightMin;
+    double weightMax;
+    uint64_t titleOffsetsPos;
+    uint64_t titleHeapPos;
+    uint64_t titleOrderPos;
+    uint64_t adjacencyOffsetsPos;
+    uint64_t neighborsPos;
+    uint64_t weightsPos;
+    uint64_t weightTablePos;
+    uint64_t weightTableSize;
+    uint64_t fileSize;
+};
+
+// Rounds a file position up to the next 8-byte boundary
+uint64_t alignGraphFilePos(uint64_t pos) {
+    return (pos + 7) & ~static_cast<uint64_t>(7);
+}
+
+// Writes titles and adjacency lists in the format above; returns false on I/O failure
+bool writeGraphFile(const std::string& path, const std::vector<std::string>& titles,
+                    const std::vector<std::vector<std::pair<size_t, double>>>& adjacency) {
+    const uint64_t n = titles.size();
+    GraphFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kGraphFileMagic, sizeof(header.magic));
+    header.version = kGraphFileVersion;
+    header.weightBits = 16;
+    header.vertexCount = n;
+
+    const size_t maxCodes = 65536;
+    std::set<double> distinct;
+    bool anyWeight = false;
+    for (const auto& list : adjacency) {
+        header.entryCount += list.size();
+        for (const auto& entry : list) {
+            if (!anyWeight || entry.second < header.weightMin) header.weightMin = entry.second;
+            if (!anyWeight || entry.second > header.weightMax) header.weightMax = entry.second;
+            anyWeight = true;
+            if (distinct.size() <= maxCodes) distinct.insert(entry.second);
+        }
+    }
+    std::vector<double> weightTable;
+    if (distinct.size() <= maxCodes) weightTable.assign(distinct.begin(), distinct.end());
+    header.weightTableSize = weightTable.size();
+
+    std::vector<uint64_t> titleOffsets(n + 1, 0);
+    for (uint64_t v = 0; v < n; ++v) {
+        titleOffsets[v + 1] = titleOffsets[v] + titles[v].size();
+    }
+
+    std::vector<uint32_t> titleOrder(n);
+    for (uint64_t v = 0; v < n; ++v) titleOrder[v] = static_cast<uint32_t>(v);
+    std::sort(titleOrder.begin(), titleOrder.end(),
+              [&titles](uint32_t a, uint32_t b) { return titles[a] < titles[b]; });
+
+    std::vector<uint64_t> adjacencyOffsets(n + 1, 0);
+    for (uint64_t v = 0; v < n; ++v) {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + adjacency[v].size();
+    }
+
+    header.titleOffsetsPos = alignGraphFilePos(sizeof(GraphFileHeader));
+    header.titleHeapPos = alignGraphFilePos(header.titleOffsetsPos + (n + 1) * sizeof(uint64_t));
+    header.titleOrderPos = alignGraphFilePos(header.titleHeapPos + titleOffsets[n]);
+    header.adjacencyOffsetsPos = alignGraphFilePos(header.titleOrderPos + n * sizeof(uint32_t));
+    header.neighborsPos = alignGraphFilePos(header.adjacencyOffsetsPos + (n + 1) * sizeof(uint64_t));
+    header.weightsPos = alignGraphFilePos(header.neighborsPos + header.entryCount * sizeof(uint32_t));
+    header.weightTablePos = alignGraphFilePos(header.weightsPos + header.entryCount * sizeof(uint16_t));
+    header.fileSize = alignGraphFilePos(header.weightTablePos + weightTable.size() * sizeof(double));
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    uint64_t written = 0;
+    auto padTo = [&file, &written](uint64_t pos) {
+        static const char zeros[8] = { 0 };
+        file.write(zeros, static_cast<std::streamsize>(pos - written));
+        written = pos;
+    };
+    auto put = [&file, &written](const void* data, uint64_t bytes) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        written += bytes;
+    };
+
+    put(&header, sizeof(header));
+    padTo(header.titleOffsetsPos);
+    put(titleOffsets.data(), titleOffsets.size() * sizeof(uint64_t));
+    padTo(header.titleHeapPos);
+    for (const auto& title : titles) put(title.data(), title.size());
+    padTo(header.titleOrderPos);
+    put(titleOrder.data(), titleOrder.size() * sizeof(uint32_t));
+    padTo(header.adjacencyOffsetsPos);
+    put(adjacencyOffsets.data(), adjacencyOffsets.size() * sizeof(uint64_t));
+
+    padTo(header.neighborsPos);
+    std::vector<uint32_t> ids;
+    for (const auto& list : adjacency) {
+        ids.clear();
+        for (const auto& entry : list) ids.push_back(static_cast<uint32_t>(entry.first));
+        put(ids.data(), ids.size() * sizeof(uint32_t));
+    }
+
+    padTo(header.weightsPos);
+    const double range = header.weightMax - header.weightMin;
+    std::vector<uint16_t> quantized;
+    for (const auto& list : adjacency) {
+        quantized.clear();
+        for (const auto& entry : list) {
+            if (!weightTable.empty()) {
+                auto code = std::lower_bound(weightTable.begin(), weightTable.end(), entry.second) - weightTable.begin();
+                quantized.push_back(static_cast<uint16_t>(code));
+            } else {
+                double q = range > 0.0 ? std::round((entry.second - header.weightMin) / range * 65535.0) : 0.0;
+                quantized.push_back(static_cast<uint16_t>(q));
+            }
+        }
+        put(quantized.data(), quantized.size() * sizeof(uint16_t));
+    }
+    padTo(header.weightTablePos);
+    put(weightTable.data(), weightTable.size() * sizeof(double));
+    padTo(header.fileSize);
+
+    return static_cast<bool>(file);
+}
+
+#endif
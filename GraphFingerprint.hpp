@@ -0,0 +1,78 @@
+#ifndef GRAPH_FINGERPRINT_HPP
+#define GRAPH_FINGERPRINT_HPP
+
+#include <cstdint>
+#include <cstring>
+
+// Identity of a graph's structure, for tables computed from a graph (landmark
+// distances, community indexes) to check that they are used with the graph
+// they were built on. The hash is the sum, modulo 2^64, of a hash of every
+// adjacency entry (vertex id, neighbor id, weight bits): it does not depend
+// on the order of the entries within a list, so reordering a list keeps it,
+// while adding, removing or reweighting an edge, or relabeling vertex ids,
+// changes it. Graph keeps its fingerprint up to date as it is edited; other
+// graph types are hashed in full by computeGraphFingerprint.
+
+struct GraphFingerprint {
+    uint64_t vertexCount = 0;
+    uint64_t entryCount = 0;
+    uint64_t hash = 0;
+
+    bool operator==(const GraphFingerprint& other) const {
+        return vertexCount == other.vertexCount && entryCount == other.entryCount && hash == other.hash;
+    }
+
+    bool operator!=(const GraphFingerprint& other) const {
+        return !(*this == other);
+    }
+};
+
+// splitmix64 finalizer
+inline uint64_t mixFingerprintBits(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Hash of the entry for neighbor v, with the given weight, in u's list
+inline uint64_t fingerprintEntry(uint64_t u, uint64_t v, double weight) {
+    uint64_t bits;
+    std::memcpy(&bits, &weight, sizeof(bits));
+    return mixFingerprintBits(mixFingerprintBits(mixFingerprintBits(u) ^ v) ^ bits);
+}
+
+// Fingerprint of any graph with vertex_count() and adjacent(v) returning
+// (neighbor id, weight) pairs, in O(vertices + entries).
+template <typename GraphType>
+GraphFingerprint computeGraphFingerprint(const GraphType& graph) {
+    GraphFingerprint fingerprint;
+    fingerprint.vertexCount = graph.vertex_count();
+    for (size_t v = 0; v < graph.vertex_count(); ++v) {
+        for (const auto& edge : graph.adjacent(v)) {
+            fingerprint.hash += fingerprintEntry(v, edge.first, edge.second);
+            ++fingerprint.entryCount;
+        }
+    }
+    return fingerprint;
+}
+
+// The graph's own fingerprint() if it keeps one (O(1) for Graph), else computed in full.
+template <typename GraphType>
+auto graphFingerprint(const GraphType& graph, int) -> decltype(GraphFingerprint(graph.fingerprint())) {
+    return graph.fingerprint();
+}
+
+template <typename GraphType>
+GraphFingerprint graphFingerprint(const GraphType& graph, long) {
+    return computeGraphFingerprint(graph);
+}
+
+template <typename GraphType>
+GraphFingerprint graphFingerprint(const GraphType& graph) {
+    return graphFingerprint(graph, 0);
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef GRAPH_TRAVERSAL_HPP
+#define GRAPH_TRAVERSAL_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <queue>
+#include <stack>
+#include <algorithm>
+
+// Traversal algorithms shared by every weighted graph representation.
+// A graph type only needs to provide:
+//   bool contains_vertex(const std::string&) const
+//   <range of (title, weight) pairs> getNeighbors(const std::string&) const
+// where each element of the range exposes `.first` (the neighbor title) and
+// `.second` (the edge weight). The range may be a materialized vector or a
+// lazily generated one.
+
+//Traverses the graph from the specified vertex in breadth-first order.
+template <typename GraphType>
+std::vector<std::string> breadthFirstSearch(const GraphType& graph, const std::string& start) {
+    std::vector<std::string> result;
+    if (!graph.contains_vertex(start)) return result;
+
+    std::unordered_map<std::string, bool> visited;
+    std::queue<std::string> q;
+
+    visited[start] = true;
+    q.push(start);
+
+    while (!q.empty()) {
+        std::string current = q.front();
+        q.pop();
+        result.push_back(current);
+
+        for (const auto& neighbor : graph.getNeighbors(current)) {
+            if (!visited[neighbor.first]) {
+                visited[neighbor.first] = true;
+                q.push(neighbor.first);
+            }
+        }
+    }
+    return result;
+}
+
+//Traverses the graph from the specified vertex in depth-first order.
+template <typename GraphType>
+std::vector<std::string> depthFirstSearch(const GraphType& graph, const std::string& start) {
+    std::vector<std::string> result;
+    if (!graph.contains_vertex(start)) return result;
+
+    std::unordered_map<std::string, bool> visited;
+    std::stack<std::string> s;
+
+    s.push(start);
+
+    while (!s.empty()) {
+        std::string current = s.top();
+        s.pop();
+
+        if (!visited[current]) {
+            visited[current] = true;
+            result.push_back(current);
+
+            for (const auto& neighbor : graph.getNeighbors(current)) {
+                if (!visited[neighbor.first]) {
+                    s.push(neighbor.first);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+//Finds a path between two vertices using a breadth-first search.
+template <typename GraphType>
+bool findPathBreadthFirst(const GraphType& graph, const std::string& start, const std::string& end, std::vector<std::string>& path) {
+    if (!graph.contains_vertex(start) || !graph.contains_vertex(end)) return false;
+
+    std::unordered_map<std::string, bool> visited;
+    std::unordered_map<std::string, std::string> parent;
+    std::queue<std::string> q;
+
+    visited[start] = true;
+    q.push(start);
+    parent[start] = "";
+
+    while (!q.empty()) {
+        std::string current = q.front();
+        q.pop();
+
+        if (current == end) {
+            std::string step = end;
+            while (!step.empty()) {
+                path.push_back(step);
+                step = parent[step];
+            }
+            std::reverse(path.begin(), path.end());
+            return true;
+        }
+
+        for (const auto& neighbor : graph.getNeighbors(current)) {
+            if (!visited[neighbor.first]) {
+                visited[neighbor.first] = true;
+                parent[neighbor.first] = current;
+                q.push(neighbor.first);
+            }
+        }
+    }
+    return false;
+}
+
+//Finds a path between two vertices using a depth-first search.
+template <typename GraphType>
+bool findPathDepthFirst(const GraphType& graph, const std::string& start, const std::string& end, std::vector<std::string>& path) {
+    if (!graph.contains_vertex(start) || !graph.contains_vertex(end)) return false;
+
+    std::unordered_map<std::string, bool> visited;
+    std::unordered_map<std::string, std::string> parent;
+    std::stack<std::string> s;
+
+    s.push(start);
+    parent[start] = "";
+
+    while (!s.empty()) {
+        std::string current = s.top();
+        s.pop();
+
+        if (!visited[current]) {
+            visited[current] = true;
+
+            if (current == end) {
+                std::string step = end;
+                while (!step.empty()) {
+                    path.push_back(step);
+                    step = parent[step];
+                }
+                std::reverse(path.begin(), path.end());
+                return true;
+            }
+
+            for (const auto& neighbor : graph.getNeighbors(current)) {
+                if (!visited[neighbor.first]) {
+                    parent[neighbor.first] = current;
+                    s.push(neighbor.first);
+                }
+            }
+        }
+    }
+    return false;
+}
+
+//Sums the edge weights along the given path.
+template <typename GraphType>
+double calculatePathDistance(const GraphType& graph, const std::vector<std::string>& path) {
+    double distance = 0.0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        for (const auto& neighbor : graph.getNeighbors(path[i - 1])) {
+            if (neighbor.first == path[i]) {
+                distance += neighbor.second;
+                break;
+            }
+        }
+    }
+    return distance;
+}
+
+#endif
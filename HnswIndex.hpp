@@ -0,0 +1,445 @@
+#ifndef HNSW_INDEX_HPP
+#define HNSW_INDEX_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Movie.hpp"
+#include "MovieFeatures.hpp"
+#include "ThreadPool.hpp"
+
+//Class that defines a Hierarchical Navigable Small World index for approximate nearest-neighbor search.
+//
+//Every movie becomes a point in a small feature space (see MovieFeatures.hpp) and the index
+//answers "the k movies closest to this one" under Euclidean distance without scanning the
+//catalog. Points live on a stack of proximity graphs: the bottom layer holds every point with
+//up to 2M links, each higher layer a random subset (about 1/M of the one below) with up to M
+//links. A query descends greedily from the single top-level entry point and then runs a best-first
+//search with a candidate list of size ef on the bottom layer. Larger M and efConstruction give a
+//better graph at a higher build cost; larger ef trades query latency for recall.
+//
+//Construction runs on a ThreadPool. Each point has its own mutex that guards its link lists, so
+//points can be inserted concurrently; the entry point is guarded by a separate mutex. Queries are
+//const and may run concurrently once build() has returned.
+class HnswIndex {
+public:
+
+    //Creates an empty index.
+    explicit HnswIndex(size_t M = 16, size_t efConstruction = 200, size_t ef = 50, unsigned seed = 42)
+    {
+        M_ = M < 2 ? 2 : M;
+        maxM0_ = 2 * M_;
+        efConstruction_ = efConstruction < M_ ? M_ : efConstruction;
+        ef_ = ef == 0 ? 1 : ef;
+        levelMultiplier_ = 1.0 / std::log(static_cast<double>(M_));
+        seed_ = seed;
+    }
+
+    //Sets the size of the candidate list used by queries.
+    void set_ef(size_t ef)
+    {
+        ef_ = ef == 0 ? 1 : ef;
+    }
+
+    //Returns the size of the candidate list used by queries.
+    size_t ef() const
+    {
+        return ef_;
+    }
+
+    //Returns the number of indexed points.
+    size_t size() const
+    {
+        return ids_.size();
+    }
+
+    //Returns the number of features per point.
+    size_t dimensions() const
+    {
+        return dims_;
+    }
+
+    //Indexes the movies by their MovieFeatures vectors; ids are the movie ids.
+    void build(const std::vector<std::pair<int, Movie>>& movies, unsigned numThreads = 0)
+    {
+        std::vector<int> ids;
+        std::vector<float> features(movies.size() * kMovieFeatureCount);
+        ids.reserve(movies.size());
+        for (size_t i = 0; i < movies.size(); ++i) {
+            ids.push_back(movies[i].second.getId());
+            movieFeatures(movies[i].second, features.data() + i * kMovieFeatureCount);
+        }
+        build(ids, std::move(features), kMovieFeatureCount, numThreads);
+    }
+
+    //Indexes arbitrary points: features holds ids.size() rows of dims values each.
+    void build(const std::vector<int>& ids, std::vector<float> features, size_t dims, unsigned numThreads = 0)
+    {
+        const size_t n = ids.size();
+        dims_ = dims;
+        ids_ = ids;
+        data_ = std::move(features);
+        idToIndex_.clear();
+        idToIndex_.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            idToIndex_[ids_[i]] = static_cast<uint32_t>(i);
+
+        // Levels are drawn up front from the seed so the layer structure is reproducible
+        std::mt19937 rng(seed_);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        levels_.assign(n, 0);
+        links_.assign(n, std::vector<std::vector<uint32_t>>());
+        for (size_t i = 0; i < n; ++i) {
+            double u = 1.0 - uniform(rng);
+            levels_[i] = static_cast<int>(-std::log(u) * levelMultiplier_);
+            links_[i].resize(levels_[i] + 1);
+        }
+        nodeLocks_.reset(new std::mutex[n == 0 ? 1 : n]);
+        visitedPool_.clear();
+
+        if (n == 0)
+            return;
+
+        entryPoint_ = 0;
+        maxLevel_ = levels_[0];
+
+        ThreadPool pool(numThreads);
+        const size_t batch = 256;
+        const size_t taskCount = (n - 1 + batch - 1) / batch;
+        pool.parallel_for(taskCount, [&](size_t task, unsigned) {
+            size_t first = 1 + task * batch;
+            size_t last = std::min(n, first + batch);
+            for (size_t i = first; i < last; ++i)
+                insert(static_cast<uint32_t>(i));
+        });
+    }
+
+    //Returns up to k (movie id, distance) pairs closest to the given movie, excluding the movie itself.
+    std::vector<std::pair<int, float>> search(int movieId, size_t k) const
+    {
+        auto it = idToIndex_.find(movieId);
+        if (it == idToIndex_.end())
+            return {};
+        return withoutSelf(searchPoint(point(it->second), k + 1), it->second, k);
+    }
+
+    //Returns up to k (id, distance) pairs closest to an arbitrary feature vector.
+    std::vector<std::pair<int, float>> search(const float* query, size_t k) const
+    {
+        return toResult(searchPoint(query, k), k);
+    }
+
+    //Exact counterpart of search(movieId, k), by scanning every point.
+    std::vector<std::pair<int, float>> search_exact(int movieId, size_t k) const
+    {
+        auto it = idToIndex_.find(movieId);
+        if (it == idToIndex_.end())
+            return {};
+        return withoutSelf(scanAll(point(it->second), k + 1), it->second, k);
+    }
+
+    //Exact counterpart of search(query, k), by scanning every point.
+    std::vector<std::pair<int, float>> search_exact(const float* query, size_t k) const
+    {
+        return toResult(scanAll(query, k), k);
+    }
+
+private:
+
+    typedef std::pair<float, uint32_t> Candidate;   /**< (squared distance, point index). */
+
+    //Epoch-stamped visited marks, reused between searches.
+    struct VisitedList {
+        std::vector<uint32_t> marks;
+        uint32_t epoch = 0;
+    };
+
+    //Returns the feature vector of a point.
+    const float* point(uint32_t i) const
+    {
+        return data_.data() + static_cast<size_t>(i) * dims_;
+    }
+
+    //Squared Euclidean distance between two feature vectors.
+    float distance(const float* a, const float* b) const
+    {
+        float sum = 0.0f;
+        for (size_t d = 0; d < dims_; ++d) {
+            float diff = a[d] - b[d];
+            sum += diff * diff;
+        }
+        return sum;
+    }
+
+    //Copies the links of a point on a level, under the point's lock while the index is being built.
+    void copyLinks(uint32_t node, int level, std::vector<uint32_t>& out, bool locking) const
+    {
+        if (locking) {
+            std::lock_guard<std::mutex> lock(nodeLocks_[node]);
+            out = links_[node][level];
+        } else {
+            out = links_[node][level];
+        }
+    }
+
+    //Takes a visited list from the pool, ready for a new search.
+    std::unique_ptr<VisitedList> acquireVisited() const
+    {
+        std::unique_ptr<VisitedList> visited;
+        {
+            std::lock_guard<std::mutex> lock(visitedMutex_);
+            if (!visitedPool_.empty()) {
+                visited = std::move(visitedPool_.back());
+                visitedPool_.pop_back();
+            }
+        }
+        if (!visited)
+            visited.reset(new VisitedList());
+        if (visited->marks.size() != ids_.size()) {
+            visited->marks.assign(ids_.size(), 0);
+            visited->epoch = 0;
+        }
+        if (++visited->epoch == 0) {
+            std::fill(visited->marks.begin(), visited->marks.end(), 0);
+            visited->epoch = 1;
+        }
+        return visited;
+    }
+
+    //Returns a visited list to the pool.
+    void releaseVisited(std::unique_ptr<VisitedList> visited) const
+    {
+        std::lock_guard<std::mutex> lock(visitedMutex_);
+        visitedPool_.push_back(std::move(visited));
+    }
+
+    //Moves greedily towards the query on one level and returns the closest point found.
+    Candidate greedyClosest(const float* query, Candidate current, int level, bool locking) const
+    {
+        std::vector<uint32_t> neighbors;
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            copyLinks(current.second, level, neighbors, locking);
+            for (uint32_t n : neighbors) {
+                float d = distance(query, point(n));
+                if (d < current.first) {
+                    current = Candidate(d, n);
+                    changed = true;
+                }
+            }
+        }
+        return current;
+    }
+
+    //Best-first search on one level; returns up to ef candidates sorted by distance.
+    std::vector<Candidate> searchLayer(const float* query, const std::vector<Candidate>& entry,
+                                       size_t ef, int level, bool locking) const
+    {
+        auto visited = acquireVisited();
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> frontier;
+        std::priority_queue<Candidate> best;
+
+        for (const auto& e : entry) {
+            if (visited->marks[e.second] == visited->epoch)
+                continue;
+            visited->marks[e.second] = visited->epoch;
+            frontier.push(e);
+            best.push(e);
+            if (best.size() > ef)
+                best.pop();
+        }
+
+        std::vector<uint32_t> neighbors;
+        while (!frontier.empty()) {
+            Candidate current = frontier.top();
+            if (best.size() >= ef && current.first > best.top().first)
+                break;
+            frontier.pop();
+
+            copyLinks(current.second, level, neighbors, locking);
+            for (uint32_t n : neighbors) {
+                if (visited->marks[n] == visited->epoch)
+                    continue;
+                visited->marks[n] = visited->epoch;
+
+                float d = distance(query, point(n));
+                if (best.size() < ef || d < best.top().first) {
+                    frontier.push(Candidate(d, n));
+                    best.push(Candidate(d, n));
+                    if (best.size() > ef)
+                        best.pop();
+                }
+            }
+        }
+        releaseVisited(std::move(visited));
+
+        std::vector<Candidate> result(best.size());
+        for (size_t i = result.size(); i-- > 0; best.pop())
+            result[i] = best.top();
+        return result;
+    }
+
+    //Neighbor selection heuristic: walks the candidates from closest to farthest and keeps one
+    //only if it is closer to the base point than to every candidate already kept, which spreads
+    //links over different directions instead of one dense cluster.
+    std::vector<Candidate> selectNeighbors(const std::vector<Candidate>& sorted, size_t maxCount) const
+    {
+        std::vector<Candidate> kept;
+        for (const auto& c : sorted) {
+            if (kept.size() >= maxCount)
+                break;
+            bool diverse = true;
+            for (const auto& k : kept) {
+                if (distance(point(c.second), point(k.second)) < c.first) {
+                    diverse = false;
+                    break;
+                }
+            }
+            if (diverse)
+                kept.push_back(c);
+        }
+        return kept;
+    }
+
+    //Links a new point into every level up to its own.
+    void insert(uint32_t node)
+    {
+        const int level = levels_[node];
+        const float* query = point(node);
+
+        // A point that raises the top level keeps the entry lock until it is linked in
+        std::unique_lock<std::mutex> entryLock(entryMutex_);
+        const int topLevel = maxLevel_;
+        const uint32_t entry = entryPoint_;
+        if (level <= topLevel)
+            entryLock.unlock();
+
+        Candidate current(distance(query, point(entry)), entry);
+        for (int l = topLevel; l > level; --l)
+            current = greedyClosest(query, current, l, true);
+
+        std::vector<Candidate> entries(1, current);
+        for (int l = std::min(level, topLevel); l >= 0; --l) {
+            std::vector<Candidate> candidates = searchLayer(query, entries, efConstruction_, l, true);
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                [node](const Candidate& c) { return c.second == node; }), candidates.end());
+
+            std::vector<Candidate> selected = selectNeighbors(candidates, M_);
+            {
+                std::lock_guard<std::mutex> lock(nodeLocks_[node]);
+                auto& own = links_[node][l];
+                own.clear();
+                for (const auto& s : selected)
+                    own.push_back(s.second);
+            }
+
+            const size_t maxLinks = l == 0 ? maxM0_ : M_;
+            for (const auto& s : selected) {
+                std::lock_guard<std::mutex> lock(nodeLocks_[s.second]);
+                auto& theirs = links_[s.second][l];
+                if (std::find(theirs.begin(), theirs.end(), node) != theirs.end())
+                    continue;
+                if (theirs.size() < maxLinks) {
+                    theirs.push_back(node);
+                    continue;
+                }
+
+                // Over capacity: re-select the neighbor's links among its old ones plus the new point
+                std::vector<Candidate> pool;
+                pool.reserve(theirs.size() + 1);
+                pool.push_back(Candidate(s.first, node));
+                for (uint32_t t : theirs)
+                    pool.push_back(Candidate(distance(point(s.second), point(t)), t));
+                std::sort(pool.begin(), pool.end());
+                theirs.clear();
+                for (const auto& kept : selectNeighbors(pool, maxLinks))
+                    theirs.push_back(kept.second);
+            }
+
+            if (!candidates.empty())
+                entries = candidates;
+        }
+
+        if (level > topLevel) {
+            maxLevel_ = level;
+            entryPoint_ = node;
+        }
+    }
+
+    //Runs a query through the layers and returns up to max(ef, k) candidates.
+    std::vector<Candidate> searchPoint(const float* query, size_t k) const
+    {
+        if (ids_.empty())
+            return {};
+
+        Candidate current(distance(query, point(entryPoint_)), entryPoint_);
+        for (int l = maxLevel_; l > 0; --l)
+            current = greedyClosest(query, current, l, false);
+
+        return searchLayer(query, std::vector<Candidate>(1, current), std::max(ef_, k), 0, false);
+    }
+
+    //Returns the k closest points by scanning all of them.
+    std::vector<Candidate> scanAll(const float* query, size_t k) const
+    {
+        std::vector<Candidate> all(ids_.size());
+        for (size_t i = 0; i < all.size(); ++i)
+            all[i] = Candidate(distance(query, point(static_cast<uint32_t>(i))), static_cast<uint32_t>(i));
+        size_t keep = std::min(k, all.size());
+        std::partial_sort(all.begin(), all.begin() + keep, all.end());
+        all.resize(keep);
+        return all;
+    }
+
+    //Converts the first k candidates into (id, distance) pairs.
+    std::vector<std::pair<int, float>> toResult(const std::vector<Candidate>& candidates, size_t k) const
+    {
+        std::vector<std::pair<int, float>> result;
+        for (size_t i = 0; i < candidates.size() && result.size() < k; ++i)
+            result.emplace_back(ids_[candidates[i].second], std::sqrt(candidates[i].first));
+        return result;
+    }
+
+    //Same as toResult, skipping the query point itself.
+    std::vector<std::pair<int, float>> withoutSelf(const std::vector<Candidate>& candidates, uint32_t self, size_t k) const
+    {
+        std::vector<Candidate> others;
+        for (const auto& c : candidates) {
+            if (c.second != self)
+                others.push_back(c);
+        }
+        return toResult(others, k);
+    }
+
+    size_t M_;                                              /**< Links per point on the upper levels. */
+    size_t maxM0_;                                          /**< Links per point on level 0. */
+    size_t efConstruction_;                                 /**< Candidate list size while building. */
+    size_t ef_;                                             /**< Candidate list size while querying. */
+    double levelMultiplier_;                                /**< Scale of the random level distribution. */
+    unsigned seed_;                                         /**< Seed for the level draws. */
+
+    size_t dims_ = 0;                                       /**< Features per point. */
+    std::vector<float> data_;                               /**< Row-major feature vectors. */
+    std::vector<int> ids_;                                  /**< Caller id of every point. */
+    std::unordered_map<int, uint32_t> idToIndex_;           /**< Caller id to point index. */
+    std::vector<int> levels_;                               /**< Top level of every point. */
+    std::vector<std::vector<std::vector<uint32_t>>> links_; /**< links_[point][level] = linked points. */
+    std::unique_ptr<std::mutex[]> nodeLocks_;               /**< One lock per point, used while building. */
+    uint32_t entryPoint_ = 0;                               /**< Point on the top level where searches start. */
+    int maxLevel_ = 0;                                      /**< Highest level in the index. */
+    std::mutex entryMutex_;                                 /**< Guards entryPoint_ and maxLevel_ while building. */
+
+    mutable std::mutex visitedMutex_;                                   /**< Guards the visited pool. */
+    mutable std::vector<std::unique_ptr<VisitedList>> visitedPool_;     /**< Reusable visited lists. */
+};
+
+#endif
@@ -0,0 +1,238 @@
+#ifndef IMPLICIT_SIMILARITY_GRAPH_HPP
+#define IMPLICIT_SIMILARITY_GRAPH_HPP
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include "Movie.hpp"
+#include "FeatureSignature.hpp"
+#include "GraphTraversal.hpp"
+
+// Similarity graph that never stores an edge.
+//
+// Two movies are adjacent when calculateSimilarity(m1, m2) >= threshold, and
+// that value only depends on the movies' FeatureSignature. The graph therefore
+// keeps each movie once, grouped into signature classes, and getNeighbors()
+// returns a lazy range that walks the members of every class similar enough to
+// the vertex's own class. Memory is O(movies + classes); the edge list of the
+// materialized Graph (quadratic on dense catalogs) is never built.
+//
+// Neighbors come in ascending vertex id (insertion) order, merging the member
+// lists of the adjacent classes with a heap, at O(log classes) per neighbor.
+// That is the order SimilarityGraphBuilder::build gives each adjacency list,
+// so for the same movies with distinct titles the traversals in
+// GraphTraversal.hpp return the same sequences on both graphs (Step4 checks
+// this). A movie whose title is already present is skipped.
+class ImplicitSimilarityGraph {
+private:
+    struct FeatureClass {
+        FeatureSignature signature;
+        std::vector<size_t> members;
+    };
+
+    double similarityThreshold_;
+    std::vector<std::string> vertices_;
+    std::vector<size_t> classOf_;
+    std::vector<FeatureClass> classes_;
+    std::unordered_map<FeatureSignature, size_t, FeatureSignatureHash> classIndex_;
+    std::unordered_map<std::string, size_t> mapping_;
+
+    bool adjacentClasses(size_t a, size_t b) const {
+        return signatureSimilarity(classes_[a].signature, classes_[b].signature) >= similarityThreshold_;
+    }
+
+public:
+    // Lazily enumerated (title, weight) pairs of one vertex, in ascending vertex id order.
+    class NeighborRange {
+    public:
+        class iterator {
+        public:
+            using value_type = std::pair<const std::string&, double>;
+
+            // An iterator over no classes is the end iterator.
+            iterator(const ImplicitSimilarityGraph* graph, size_t self, bool begin)
+                : graph_(graph), self_(self) {
+                if (!begin) return;
+                size_t own = graph_->classOf_[self_];
+                for (size_t cls = 0; cls < graph_->classes_.size(); ++cls) {
+                    if (graph_->adjacentClasses(own, cls)) {
+                        heap_.push_back({ graph_->classes_[cls].members.front(), cls, 0 });
+                    }
+                }
+                std::make_heap(heap_.begin(), heap_.end(), later);
+                settle();
+            }
+
+            value_type operator*() const {
+                size_t v = heap_.front().vertex;
+                return value_type(graph_->vertices_[v], 1.0 - graph_->similarity(self_, v));
+            }
+
+            iterator& operator++() {
+                advance();
+                settle();
+                return *this;
+            }
+
+            bool operator==(const iterator& other) const {
+                if (heap_.empty() || other.heap_.empty()) return heap_.empty() == other.heap_.empty();
+                return heap_.front().vertex == other.heap_.front().vertex;
+            }
+
+            bool operator!=(const iterator& other) const {
+                return !(*this == other);
+            }
+
+        private:
+            // Next unvisited member of one adjacent class; members are in ascending id order.
+            struct Cursor {
+                size_t vertex;
+                size_t cls;
+                size_t member;
+            };
+
+            const ImplicitSimilarityGraph* graph_;
+            size_t self_;
+            std::vector<Cursor> heap_;   // min-heap on vertex: the classes are merged by id
+
+            static bool later(const Cursor& a, const Cursor& b) {
+                return a.vertex > b.vertex;
+            }
+
+            // Moves the smallest cursor to its class's next member, dropping exhausted classes.
+            void advance() {
+                std::pop_heap(heap_.begin(), heap_.end(), later);
+                Cursor& cursor = heap_.back();
+                const auto& members = graph_->classes_[cursor.cls].members;
+                if (++cursor.member < members.size()) {
+                    cursor.vertex = members[cursor.member];
+                    std::push_heap(heap_.begin(), heap_.end(), later);
+                } else {
+                    heap_.pop_back();
+                }
+            }
+
+            // Skips the vertex itself.
+            void settle() {
+                while (!heap_.empty() && heap_.front().vertex == self_) advance();
+            }
+        };
+
+        NeighborRange(const ImplicitSimilarityGraph* graph, size_t self, bool valid)
+            : graph_(graph), self_(self), valid_(valid) {}
+
+        iterator begin() const {
+            return iterator(graph_, self_, valid_);
+        }
+
+        iterator end() const {
+            return iterator(graph_, self_, false);
+        }
+
+        bool empty() const {
+            return begin() == end();
+        }
+
+    private:
+        const ImplicitSimilarityGraph* graph_;
+        size_t self_;
+        bool valid_;
+    };
+
+    explicit ImplicitSimilarityGraph(double similarityThreshold = 0.5)
+        : similarityThreshold_(similarityThreshold) {}
+
+    void add_movie(const Movie& movie) {
+        const std::string title = movie.getTitle();
+        if (contains_vertex(title)) {
+            std::cout << "Vertex with the same id already exists" << std::endl;
+            return;
+        }
+
+        FeatureSignature signature(movie);
+        auto it = classIndex_.find(signature);
+        if (it == classIndex_.end()) {
+            it = classIndex_.emplace(signature, classes_.size()).first;
+            classes_.push_back({ signature, {} });
+        }
+
+        size_t id = vertices_.size();
+        vertices_.push_back(title);
+        classOf_.push_back(it->second);
+        classes_[it->second].members.push_back(id);
+        mapping_[title] = id;
+    }
+
+    bool contains_vertex(const std::string& v) const {
+        return mapping_.find(v) != mapping_.end();
+    }
+
+    size_t vertex_count() const {
+        return vertices_.size();
+    }
+
+    size_t class_count() const {
+        return classes_.size();
+    }
+
+    // Bytes held for the graph structure (class of every vertex, class member
+    // lists and signatures), not counting titles or the title index.
+    size_t memory_bytes() const {
+        return classOf_.size() * sizeof(size_t) + vertices_.size() * sizeof(size_t) +
+               classes_.size() * sizeof(FeatureClass);
+    }
+
+    double threshold() const {
+        return similarityThreshold_;
+    }
+
+    // Similarity of two vertices by id, identical to calculateSimilarity on their movies.
+    double similarity(size_t a, size_t b) const {
+        return signatureSimilarity(classes_[classOf_[a]].signature, classes_[classOf_[b]].signature);
+    }
+
+    NeighborRange getNeighbors(const std::string& movie) const {
+        auto it = mapping_.find(movie);
+        if (it == mapping_.end()) {
+            return NeighborRange(this, 0, false);
+        }
+        return NeighborRange(this, it->second, true);
+    }
+
+    void displayAdjacent(const std::string& movie) const {
+        std::cout << "Neighbors of \"" << movie << "\":\n";
+        auto neighbors = getNeighbors(movie);
+        if (!neighbors.empty()) {
+            for (const auto& neighbor : neighbors) {
+                std::cout << " - " << neighbor.first << " (weight: " << neighbor.second << ")" << std::endl;
+            }
+        } else {
+            std::cout << "The movie \"" << movie << "\" has no adjacent movies or is not in the graph." << std::endl;
+        }
+    }
+
+    std::vector<std::string> bfs(const std::string& start) const {
+        return breadthFirstSearch(*this, start);
+    }
+
+    std::vector<std::string> dfs(const std::string& start) const {
+        return depthFirstSearch(*this, start);
+    }
+
+    bool find_path_bfs(const std::string& start, const std::string& end, std::vector<std::string>& path) const {
+        return findPathBreadthFirst(*this, start, end, path);
+    }
+
+    bool find_path_dfs(const std::string& start, const std::string& end, std::vector<std::string>& path) const {
+        return findPathDepthFirst(*this, start, end, path);
+    }
+
+    double calculate_path_distance(const std::vector<std::string>& path) const {
+        return calculatePathDistance(*this, path);
+    }
+};
+
+#endif
@@ -0,0 +1,269 @@
+#ifndef LANDMARK_ORACLE_HPP
+#define LANDMARK_ORACLE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+#include "GraphFingerprint.hpp"
+#include "MultiSourceBfs.hpp"
+#include "ShortestPath.hpp"
+#include "ThreadPool.hpp"
+
+// On-disk layout of the landmark tables:
+//   LandmarkFileHeader
+//   uint64_t landmarks[landmarkCount]
+//   double   distances[landmarkCount * vertexCount]   row per landmark, infinity if unreachable
+
+const char kLandmarkFileMagic[8] = { 'M', 'O', 'V', 'L', 'M', 'R', 'K', '2' };
+
+struct LandmarkFileHeader {
+    char magic[8];
+    uint64_t landmarkCount;
+    uint64_t vertexCount;
+    uint64_t entryCount;        // fingerprint of the graph the tables were built on
+    uint64_t graphHash;
+};
+
+//Class that defines a landmark (ALT) distance oracle over the vertex ids of a weighted graph.
+//
+//Preprocessing stores the shortest-path distance from k landmark vertices to every vertex. By the
+//triangle inequality, every landmark L bounds the distance between u and v:
+//    |d(L, u) - d(L, v)|  <=  d(u, v)  <=  d(L, u) + d(L, v)
+//so the best bounds over all landmarks answer "how far apart are these two movies" in O(k)
+//without searching the graph. The lower bound is also an admissible, consistent A* heuristic
+//(altShortestPath). Landmarks are picked by farthest-point selection on hop distance, which
+//spreads them to the edges of the graph, where their bounds are tightest. The graph type needs
+//vertex_count() and adjacent(v) returning (neighbor id, weight) pairs with non-negative weights.
+//
+//The tables describe the graph as it was when they were built. The oracle records the graph's
+//fingerprint (GraphFingerprint.hpp), saves it with the tables and checks it on load; built_for()
+//tells whether a graph is that graph in that state, and altShortestPath falls back to plain
+//search when it is not. The check is O(1) for Graph and hashes every entry of other graph
+//types. Bounds for vertex ids the tables do not cover are trivial (0 and infinity).
+class LandmarkOracle {
+public:
+
+    //Picks `landmarkCount` landmarks and computes their distance tables, one Dijkstra per
+    //landmark in parallel (0 threads uses every core).
+    template <typename GraphType>
+    void build(const GraphType& graph, size_t landmarkCount, unsigned numThreads = 0)
+    {
+        vertexCount_ = graph.vertex_count();
+        fingerprint_ = graphFingerprint(graph);
+        landmarks_.clear();
+        distances_.clear();
+        if (vertexCount_ == 0)
+            return;
+        landmarkCount = std::min(landmarkCount, vertexCount_);
+
+        ThreadPool pool(numThreads);
+
+        // Farthest-point selection: each new landmark is the vertex with the largest hop
+        // distance to the landmarks chosen so far; vertices no landmark reaches count as
+        // farthest, so other components get landmarks too. The first one is the
+        // highest-degree vertex.
+        size_t first = 0;
+        for (size_t v = 1; v < vertexCount_; ++v) {
+            if (graph.adjacent(v).size() > graph.adjacent(first).size())
+                first = v;
+        }
+        std::vector<uint32_t> nearest(vertexCount_, kUnreachable);
+        for (size_t next = first; landmarks_.size() < landmarkCount;) {
+            landmarks_.push_back(next);
+            std::vector<uint32_t> hops = multiSourceBfs(graph, std::vector<size_t>(1, next), pool)[0];
+            for (size_t v = 0; v < vertexCount_; ++v)
+                nearest[v] = std::min(nearest[v], hops[v]);
+            next = static_cast<size_t>(std::max_element(nearest.begin(), nearest.end()) - nearest.begin());
+            if (nearest[next] == 0)
+                break;
+        }
+
+        distances_.resize(landmarks_.size() * vertexCount_);
+        pool.parallel_for(landmarks_.size(), [&](size_t l, unsigned) {
+            std::vector<double> row = dijkstraDistances(graph, landmarks_[l]);
+            std::copy(row.begin(), row.end(), distances_.begin() + l * vertexCount_);
+        });
+    }
+
+    //Returns the number of landmarks.
+    size_t landmark_count() const
+    {
+        return landmarks_.size();
+    }
+
+    //Returns the number of vertices the tables cover.
+    size_t vertex_count() const
+    {
+        return vertexCount_;
+    }
+
+    //Returns whether the tables were built for a graph with this graph's fingerprint: the same
+    //vertex ids and edges, whatever object holds them.
+    template <typename GraphType>
+    bool built_for(const GraphType& graph) const
+    {
+        return vertexCount_ == graph.vertex_count() && fingerprint_ == graphFingerprint(graph);
+    }
+
+    //Returns the landmark vertex ids.
+    const std::vector<size_t>& landmarks() const
+    {
+        return landmarks_;
+    }
+
+    //Returns the distance from the l-th landmark to a vertex.
+    double landmark_distance(size_t l, size_t v) const
+    {
+        return distances_[l * vertexCount_ + v];
+    }
+
+    //Returns a lower bound on the distance between two vertices (infinity if a landmark shows
+    //they are disconnected, 0 if no landmark knows either or the tables do not cover them).
+    double lower_bound(size_t u, size_t v) const
+    {
+        double best = 0.0;
+        if (u >= vertexCount_ || v >= vertexCount_)
+            return best;
+        for (size_t l = 0; l < landmarks_.size(); ++l) {
+            double du = landmark_distance(l, u);
+            double dv = landmark_distance(l, v);
+            if (std::isinf(du) != std::isinf(dv))
+                return std::numeric_limits<double>::infinity();
+            if (!std::isinf(du))
+                best = std::max(best, std::fabs(du - dv));
+        }
+        return best;
+    }
+
+    //Returns an upper bound on the distance between two vertices (infinity if no landmark
+    //reaches both or the tables do not cover them).
+    double upper_bound(size_t u, size_t v) const
+    {
+        double best = std::numeric_limits<double>::infinity();
+        if (u >= vertexCount_ || v >= vertexCount_)
+            return best;
+        for (size_t l = 0; l < landmarks_.size(); ++l)
+            best = std::min(best, landmark_distance(l, u) + landmark_distance(l, v));
+        return best;
+    }
+
+    //Writes the landmark tables to a file; returns false on I/O failure.
+    bool save(const std::string& path) const
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+
+        LandmarkFileHeader header;
+        std::memcpy(header.magic, kLandmarkFileMagic, sizeof(header.magic));
+        header.landmarkCount = landmarks_.size();
+        header.vertexCount = vertexCount_;
+        header.entryCount = fingerprint_.entryCount;
+        header.graphHash = fingerprint_.hash;
+        std::vector<uint64_t> landmarks(landmarks_.begin(), landmarks_.end());
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(landmarks.data()), landmarks.size() * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(distances_.data()), distances_.size() * sizeof(double));
+        return static_cast<bool>(file);
+    }
+
+    //Reads landmark tables written by save(); returns false if the file is missing, malformed, or
+    //was built for a graph whose fingerprint differs from this graph's (another threshold or k,
+    //or edits since).
+    template <typename GraphType>
+    bool load(const std::string& path, const GraphType& graph)
+    {
+        const GraphFingerprint fingerprint = graphFingerprint(graph);
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return false;
+
+        LandmarkFileHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, kLandmarkFileMagic, sizeof(header.magic)) != 0 ||
+            header.vertexCount != fingerprint.vertexCount || header.entryCount != fingerprint.entryCount ||
+            header.graphHash != fingerprint.hash || header.landmarkCount > header.vertexCount)
+            return false;
+
+        std::vector<uint64_t> landmarks(header.landmarkCount);
+        std::vector<double> distances(header.landmarkCount * header.vertexCount);
+        if (!file.read(reinterpret_cast<char*>(landmarks.data()), landmarks.size() * sizeof(uint64_t)) ||
+            !file.read(reinterpret_cast<char*>(distances.data()), distances.size() * sizeof(double)))
+            return false;
+
+        vertexCount_ = static_cast<size_t>(header.vertexCount);
+        fingerprint_ = fingerprint;
+        landmarks_.assign(landmarks.begin(), landmarks.end());
+        distances_ = std::move(distances);
+        return true;
+    }
+
+private:
+    size_t vertexCount_ = 0;            /**< Number of vertices of the graph. */
+    GraphFingerprint fingerprint_;      /**< Fingerprint of the graph the tables describe. */
+    std::vector<size_t> landmarks_;     /**< Landmark vertex ids. */
+    std::vector<double> distances_;     /**< distances_[l * vertexCount_ + v] = d(landmark l, v). */
+};
+
+// Exact minimal-weight path between two vertex ids with A* search guided
+// by the oracle's lower bounds (ALT). The bound is consistent, so every
+// vertex is settled at most once and the first time the target is popped
+// its distance is final. The search settles only vertices whose distance
+// plus bound stays below the answer, not the whole Dijkstra ball. If the
+// oracle was not built for this graph as it is now (see built_for), its
+// bounds may be wrong, so the search falls back to bidirectional Dijkstra.
+template <typename GraphType>
+bool altShortestPath(const GraphType& graph, const LandmarkOracle& oracle, size_t source, size_t target,
+                     std::vector<size_t>& path, double& distance) {
+    const size_t n = graph.vertex_count();
+    const double infinity = std::numeric_limits<double>::infinity();
+    const size_t none = static_cast<size_t>(-1);
+    path.clear();
+    if (source >= n || target >= n) return false;
+    if (!oracle.built_for(graph)) return bidirectionalDijkstra(graph, source, target, path, distance);
+    if (std::isinf(oracle.lower_bound(source, target))) return false;
+
+    std::vector<double> dist(n, infinity);
+    std::vector<size_t> parent(n, none);
+    std::vector<char> settled(n, 0);
+    typedef std::pair<double, size_t> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+    dist[source] = 0.0;
+    open.emplace(oracle.lower_bound(source, target), source);
+    while (!open.empty()) {
+        size_t u = open.top().second;
+        open.pop();
+        if (settled[u]) continue;
+        settled[u] = 1;
+        if (u == target) break;
+
+        for (const auto& edge : graph.adjacent(u)) {
+            size_t v = edge.first;
+            double candidate = dist[u] + edge.second;
+            if (!settled[v] && candidate < dist[v]) {
+                dist[v] = candidate;
+                parent[v] = u;
+                open.emplace(candidate + oracle.lower_bound(v, target), v);
+            }
+        }
+    }
+
+    if (!settled[target]) return false;
+    for (size_t v = target; v != none; v = parent[v])
+        path.push_back(v);
+    std::reverse(path.begin(), path.end());
+    distance = dist[target];
+    return true;
+}
+
+#endif
@@ -0,0 +1,267 @@
+#ifndef LAZY_TRAVERSAL_HPP
+#define LAZY_TRAVERSAL_HPP
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include "TraversalContext.hpp"
+
+// Limits on what a lazy traversal yields.
+//   maxDepth    vertices further than this many hops (along the traversal
+//               tree) are neither yielded nor expanded
+//   maxResults  the traversal ends after yielding this many vertices
+//   filter      vertices it rejects are not yielded (nor counted towards
+//               maxResults) but are still traversed through; empty accepts
+//               every vertex
+struct TraversalLimits {
+    size_t maxDepth = std::numeric_limits<size_t>::max();
+    size_t maxResults = std::numeric_limits<size_t>::max();
+    std::function<bool(size_t)> filter;
+};
+
+//Class that defines the input iterator over a lazy traversal, for range-based for loops.
+template <typename Traversal>
+class TraversalIterator {
+public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef size_t value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const size_t* pointer;
+    typedef const size_t& reference;
+
+    TraversalIterator() = default;
+
+    explicit TraversalIterator(Traversal& traversal) : traversal_(&traversal)
+    {
+        ++*this;
+    }
+
+    const size_t& operator*() const
+    {
+        return vertex_;
+    }
+
+    TraversalIterator& operator++()
+    {
+        if (!traversal_->next(vertex_))
+            traversal_ = nullptr;
+        return *this;
+    }
+
+    bool operator==(const TraversalIterator& other) const
+    {
+        return traversal_ == other.traversal_;
+    }
+
+    bool operator!=(const TraversalIterator& other) const
+    {
+        return traversal_ != other.traversal_;
+    }
+
+private:
+    Traversal* traversal_ = nullptr;    /**< Null once the traversal has ended. */
+    size_t vertex_ = 0;                 /**< Current vertex id. */
+};
+
+//Class that defines a breadth-first traversal over vertex ids that advances only as far as its caller reads.
+//
+//Vertices come in the order of breadthFirstOrder, the source first. A vertex is yielded as soon
+//as it is discovered, and the scan of the vertex being expanded resumes on the next call, so
+//reading k vertices costs the edges scanned until the k-th discovery rather than a search of the
+//whole component. Once the traversal reaches maxDepth it ends without scanning the last level's
+//edges. The graph type needs vertex_count() and adjacent(v) returning a random-access range of
+//(neighbor id, weight) pairs; the graph must outlive the traversal and not change under it.
+//Scratch space comes from the calling thread's TraversalContext pool.
+template <typename GraphType>
+class BreadthFirstTraversal {
+public:
+    BreadthFirstTraversal(const GraphType& graph, size_t source, TraversalLimits limits = TraversalLimits())
+        : graph_(graph), limits_(std::move(limits))
+    {
+        context_->reset(graph.vertex_count());
+        if (source >= graph.vertex_count()) {
+            done_ = true;
+            return;
+        }
+        context_->visit(source);
+        context_->pending().push_back(static_cast<uint32_t>(source));
+        sourcePending_ = true;
+    }
+
+    //Stores the next vertex in v; returns false once the traversal has ended.
+    bool next(size_t& v)
+    {
+        if (done_ || yielded_ >= limits_.maxResults) {
+            done_ = true;
+            return false;
+        }
+        if (sourcePending_) {
+            sourcePending_ = false;
+            if (accept(context_->pending()[0], 0, v))
+                return true;
+        }
+
+        auto& queue = context_->pending();
+        while (head_ < queue.size() && headDepth_ < limits_.maxDepth) {
+            const auto& neighbors = graph_.adjacent(queue[head_]);
+            while (edge_ < neighbors.size()) {
+                size_t u = neighbors[edge_++].first;
+                if (context_->visited(u)) continue;
+                context_->visit(u);
+                queue.push_back(static_cast<uint32_t>(u));
+                if (accept(u, headDepth_ + 1, v))
+                    return true;
+            }
+            edge_ = 0;
+            if (++head_ == levelEnd_) {
+                ++headDepth_;
+                levelEnd_ = queue.size();
+            }
+        }
+        done_ = true;
+        return false;
+    }
+
+    //Returns the depth of the vertex last yielded.
+    size_t depth() const
+    {
+        return depth_;
+    }
+
+    TraversalIterator<BreadthFirstTraversal> begin()
+    {
+        return TraversalIterator<BreadthFirstTraversal>(*this);
+    }
+
+    TraversalIterator<BreadthFirstTraversal> end()
+    {
+        return TraversalIterator<BreadthFirstTraversal>();
+    }
+
+private:
+
+    bool accept(size_t u, size_t depth, size_t& v)
+    {
+        if (limits_.filter && !limits_.filter(u))
+            return false;
+        v = u;
+        depth_ = depth;
+        ++yielded_;
+        return true;
+    }
+
+    const GraphType& graph_;
+    TraversalLimits limits_;
+    TraversalContextLease context_;     /**< Visited marks; its pending() vector is the queue. */
+    size_t head_ = 0;                   /**< Queue position of the vertex being expanded. */
+    size_t edge_ = 0;                   /**< Next adjacency entry of that vertex to scan. */
+    size_t headDepth_ = 0;              /**< Depth of the vertex being expanded. */
+    size_t levelEnd_ = 1;               /**< Queue position where the next level starts. */
+    size_t depth_ = 0;
+    size_t yielded_ = 0;
+    bool sourcePending_ = false;
+    bool done_ = false;
+};
+
+//Class that defines a depth-first traversal over vertex ids that advances only as far as its caller reads.
+//
+//Vertices come in the order of depthFirstOrder. A vertex's neighbors are pushed only when the
+//next vertex is requested, so reading k vertices costs the degrees of the vertices read rather
+//than a search of the whole component. Depth is measured along the traversal tree: with a
+//maxDepth, a vertex first reached by a path longer than the limit is skipped even if a shorter
+//path exists. Requirements are those of BreadthFirstTraversal.
+template <typename GraphType>
+class DepthFirstTraversal {
+public:
+    DepthFirstTraversal(const GraphType& graph, size_t source, TraversalLimits limits = TraversalLimits())
+        : graph_(graph), limits_(std::move(limits))
+    {
+        context_->reset(graph.vertex_count());
+        if (source >= graph.vertex_count()) {
+            done_ = true;
+            return;
+        }
+        push(source, 0);
+    }
+
+    //Stores the next vertex in v; returns false once the traversal has ended.
+    bool next(size_t& v)
+    {
+        if (done_ || yielded_ >= limits_.maxResults) {
+            done_ = true;
+            return false;
+        }
+
+        if (expandLast_) {
+            expandLast_ = false;
+            expand(last_, depth_);
+        }
+        // The stack holds (vertex, depth) entries flattened into pending()
+        auto& stack = context_->pending();
+        while (!stack.empty()) {
+            size_t depth = stack.back();
+            stack.pop_back();
+            size_t current = stack.back();
+            stack.pop_back();
+            if (context_->visited(current)) continue;
+            context_->visit(current);
+            if (limits_.filter && !limits_.filter(current)) {
+                expand(current, depth);
+                continue;
+            }
+            v = last_ = current;
+            depth_ = depth;
+            expandLast_ = true;
+            ++yielded_;
+            return true;
+        }
+        done_ = true;
+        return false;
+    }
+
+    //Returns the depth of the vertex last yielded.
+    size_t depth() const
+    {
+        return depth_;
+    }
+
+    TraversalIterator<DepthFirstTraversal> begin()
+    {
+        return TraversalIterator<DepthFirstTraversal>(*this);
+    }
+
+    TraversalIterator<DepthFirstTraversal> end()
+    {
+        return TraversalIterator<DepthFirstTraversal>();
+    }
+
+private:
+
+    void push(size_t v, size_t depth)
+    {
+        context_->pending().push_back(static_cast<uint32_t>(v));
+        context_->pending().push_back(static_cast<uint32_t>(depth));
+    }
+
+    void expand(size_t v, size_t depth)
+    {
+        if (depth >= limits_.maxDepth)
+            return;
+        for (const auto& edge : graph_.adjacent(v)) {
+            if (!context_->visited(edge.first)) push(edge.first, depth + 1);
+        }
+    }
+
+    const GraphType& graph_;
+    TraversalLimits limits_;
+    TraversalContextLease context_;     /**< Visited marks; its pending() vector is the stack. */
+    size_t last_ = 0;                   /**< Vertex last yielded. */
+    size_t depth_ = 0;
+    size_t yielded_ = 0;
+    bool expandLast_ = false;           /**< Whether last_'s neighbors are still to be pushed. */
+    bool done_ = false;
+};
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef MAPPED_GRAPH_HPP
+#define MAPPED_GRAPH_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "GraphFile.hpp"
+#include "GraphTraversal.hpp"
+
+//Class that defines a read-only weighted graph served straight from a memory-mapped graph file.
+//
+//open() maps a file written by Graph::save() and validates its structure: the header, that every
+//section lies inside the file, and that the title and adjacency offsets are monotone and stay in
+//their sections (O(vertices)). Neighbor ids and weight codes are trusted as written. Titles,
+//adjacency lists and weights are read in place, nothing is parsed or copied. Processes that map the same
+//file share its physical pages through the page cache, so any number of query workers costs the
+//memory of one graph. Vertex lookup by title is a binary search over the sorted title index
+//stored in the file. The traversal API matches Graph's, so the same queries run on either.
+class MappedGraph {
+public:
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    MappedGraph() = default;
+
+    MappedGraph(const MappedGraph&) = delete;
+    MappedGraph& operator=(const MappedGraph&) = delete;
+
+    //Unmaps the file.
+    ~MappedGraph()
+    {
+        close();
+    }
+
+    //Maps the graph file at the given path; returns false if it is missing or not a graph file.
+    bool open(const std::string& path)
+    {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < sizeof(GraphFileHeader)) {
+            ::close(fd);
+            return false;
+        }
+
+        void* base = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED)
+            return false;
+
+        base_ = static_cast<const char*>(base);
+        size_ = static_cast<size_t>(info.st_size);
+        header_ = reinterpret_cast<const GraphFileHeader*>(base_);
+
+        if (std::memcmp(header_->magic, kGraphFileMagic, sizeof(kGraphFileMagic)) != 0 ||
+            header_->version != kGraphFileVersion || header_->weightBits != 16 || header_->fileSize != size_ ||
+            !valid_sections()) {
+            std::cout << "Not a valid graph file: " << path << std::endl;
+            close();
+            return false;
+        }
+
+        titleOffsets_ = section<uint64_t>(header_->titleOffsetsPos);
+        titleHeap_ = base_ + header_->titleHeapPos;
+        titleOrder_ = section<uint32_t>(header_->titleOrderPos);
+        adjacencyOffsets_ = section<uint64_t>(header_->adjacencyOffsetsPos);
+        neighbors_ = section<uint32_t>(header_->neighborsPos);
+        weights_ = section<uint16_t>(header_->weightsPos);
+        weightTable_ = header_->weightTableSize > 0 ? section<double>(header_->weightTablePos) : nullptr;
+        weightScale_ = (header_->weightMax - header_->weightMin) / 65535.0;
+        return true;
+    }
+
+    //Unmaps the file, if any.
+    void close()
+    {
+        if (base_ != nullptr)
+            munmap(const_cast<char*>(base_), size_);
+        base_ = nullptr;
+        header_ = nullptr;
+        size_ = 0;
+    }
+
+    //Checks if a graph file is mapped.
+    bool is_open() const
+    {
+        return base_ != nullptr;
+    }
+
+    //Returns the number of vertices.
+    size_t vertex_count() const
+    {
+        return header_ ? static_cast<size_t>(header_->vertexCount) : 0;
+    }
+
+    //Returns the number of adjacency entries (twice the number of undirected edges).
+    size_t entry_count() const
+    {
+        return header_ ? static_cast<size_t>(header_->entryCount) : 0;
+    }
+
+    //Returns the title of a vertex, pointing into the mapping.
+    std::string_view title(size_t v) const
+    {
+        return std::string_view(titleHeap_ + titleOffsets_[v], titleOffsets_[v + 1] - titleOffsets_[v]);
+    }
+
+    //Returns the id of the vertex with the given title, or npos.
+    size_t vertex_id(std::string_view t) const
+    {
+        size_t lo = 0, hi = vertex_count();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            int cmp = title(titleOrder_[mid]).compare(t);
+            if (cmp == 0)
+                return titleOrder_[mid];
+            if (cmp < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return npos;
+    }
+
+    //Checks if the graph contains the specified vertex.
+    bool contains_vertex(const std::string& v) const
+    {
+        return vertex_id(v) != npos;
+    }
+
+    //Returns the number of neighbors of a vertex.
+    size_t degree(size_t v) const
+    {
+        return static_cast<size_t>(adjacencyOffsets_[v + 1] - adjacencyOffsets_[v]);
+    }
+
+    //Returns the i-th neighbor id of a vertex.
+    size_t neighbor(size_t v, size_t i) const
+    {
+        return neighbors_[adjacencyOffsets_[v] + i];
+    }
+
+    //Returns the weight of the edge to the i-th neighbor of a vertex.
+    double weight(size_t v, size_t i) const
+    {
+        uint16_t code = weights_[adjacencyOffsets_[v] + i];
+        return weightTable_ ? weightTable_[code] : header_->weightMin + code * weightScale_;
+    }
+
+    //Returns the neighbors of the specified vertex with their weights.
+    std::vector<std::pair<std::string, double>> getNeighbors(const std::string& movie) const
+    {
+        std::vector<std::pair<std::string, double>> result;
+        size_t v = vertex_id(movie);
+        if (v == npos)
+            return result;
+        result.reserve(degree(v));
+        for (size_t i = 0; i < degree(v); ++i)
+            result.emplace_back(std::string(title(neighbor(v, i))), weight(v, i));
+        return result;
+    }
+
+    //Prints the neighbors of the specified vertex.
+    void displayAdjacent(const std::string& movie) const
+    {
+        std::cout << "Neighbors of \"" << movie << "\":\n";
+        auto neighbors = getNeighbors(movie);
+        if (!neighbors.empty()) {
+            for (const auto& neighbor : neighbors) {
+                std::cout << " - " << neighbor.first << " (weight: " << neighbor.second << ")" << std::endl;
+            }
+        } else {
+            std::cout << "The movie \"" << movie << "\" has no adjacent movies or is not in the graph." << std::endl;
+        }
+    }
+
+    std::vector<std::string> bfs(const std::string& start) const
+    {
+        return breadthFirstSearch(*this, start);
+    }
+
+    std::vector<std::string> dfs(const std::string& start) const
+    {
+        return depthFirstSearch(*this, start);
+    }
+
+    bool find_path_bfs(const std::string& start, const std::string& end, std::vector<std::string>& path) const
+    {
+        return findPathBreadthFirst(*this, start, end, path);
+    }
+
+    bool find_path_dfs(const std::string& start, const std::string& end, std::vector<std::string>& path) const
+    {
+        return findPathDepthFirst(*this, start, end, path);
+    }
+
+    double calculate_path_distance(const std::vector<std::string>& path) const
+    {
+        return calculatePathDistance(*this, path);
+    }
+
+private:
+
+    //Checks that `count` elements of `elementSize` bytes at file position `pos` lie inside the
+    //mapping, starting on an 8-byte boundary.
+    bool fits(uint64_t pos, uint64_t count, uint64_t elementSize) const
+    {
+        return pos % 8 == 0 && pos <= size_ && count <= (size_ - pos) / elementSize;
+    }
+
+    //Checks that every section of the header lies inside the file, that the title offsets rise
+    //from 0 and stay inside the title heap, that the title order holds vertex ids, and that the
+    //adjacency offsets rise from 0 to the entry count. Run before any section is read.
+    bool valid_sections() const
+    {
+        const uint64_t n = header_->vertexCount;
+        const uint64_t entries = header_->entryCount;
+        if (n >= size_ || n > UINT32_MAX || header_->weightTableSize > 65536 ||
+            !fits(header_->titleOffsetsPos, n + 1, sizeof(uint64_t)) ||
+            !fits(header_->titleOrderPos, n, sizeof(uint32_t)) ||
+            !fits(header_->adjacencyOffsetsPos, n + 1, sizeof(uint64_t)) ||
+            !fits(header_->neighborsPos, entries, sizeof(uint32_t)) ||
+            !fits(header_->weightsPos, entries, sizeof(uint16_t)) ||
+            !fits(header_->weightTablePos, header_->weightTableSize, sizeof(double)))
+            return false;
+
+        const uint64_t* titleOffsets = section<uint64_t>(header_->titleOffsetsPos);
+        const uint64_t* adjacencyOffsets = section<uint64_t>(header_->adjacencyOffsetsPos);
+        const uint32_t* titleOrder = section<uint32_t>(header_->titleOrderPos);
+        if (titleOffsets[0] != 0 || adjacencyOffsets[0] != 0 || adjacencyOffsets[n] != entries ||
+            header_->titleHeapPos > size_ || titleOffsets[n] > size_ - header_->titleHeapPos)
+            return false;
+        for (uint64_t v = 0; v < n; ++v) {
+            if (titleOffsets[v + 1] < titleOffsets[v] || adjacencyOffsets[v + 1] < adjacencyOffsets[v] ||
+                titleOrder[v] >= n)
+                return false;
+        }
+        return true;
+    }
+
+    //Returns a typed pointer to the section at the given file position.
+    template <typename T>
+    const T* section(uint64_t pos) const
+    {
+        return reinterpret_cast<const T*>(base_ + pos);
+    }
+
+    const char* base_ = nullptr;                    /**< Start of the mapping. */
+    size_t size_ = 0;                               /**< Length of the mapping. */
+    const GraphFileHeader* header_ = nullptr;       /**< File header. */
+    const uint64_t* titleOffsets_ = nullptr;        /**< Title byte ranges. */
+    const char* titleHeap_ = nullptr;               /**< Title characters. */
+    const uint32_t* titleOrder_ = nullptr;          /**< Vertex ids sorted by title. */
+    const uint64_t* adjacencyOffsets_ = nullptr;    /**< Start of every adjacency list. */
+    const uint32_t* neighbors_ = nullptr;           /**< Neighbor ids. */
+    const uint16_t* weights_ = nullptr;             /**< Quantized weights. */
+    const double* weightTable_ = nullptr;           /**< Exact weight of every code, if the file has a codebook. */
+    double weightScale_ = 0.0;                      /**< Weight per quantization step. */
+};
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef MIN_HASH_LSH_HPP
+#define MIN_HASH_LSH_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Movie.hpp"
+#include "ThreadPool.hpp"
+
+// Feature tokens of a movie, one per feature calculateSimilarity compares.
+// A token encodes the feature and its value, so two movies share a token
+// exactly when that feature matches and their Jaccard similarity grows with
+// calculateSimilarity (m matching features out of 5 give m / (10 - m)). New
+// features added to the similarity function should add a token here.
+std::vector<uint64_t> similarityTokens(const Movie& movie) {
+    return {
+        (1ULL << 56) | static_cast<uint32_t>(movie.getYear()),
+        (2ULL << 56) | (movie.isNetflix() ? 1u : 0u),
+        (3ULL << 56) | (movie.isHulu() ? 1u : 0u),
+        (4ULL << 56) | (movie.isPrimeVideo() ? 1u : 0u),
+        (5ULL << 56) | (movie.isDisneyPlus() ? 1u : 0u)
+    };
+}
+
+//Class that generates candidate pairs for a similarity join with MinHash locality-sensitive hashing.
+//
+//Every movie gets a signature of bands * rows MinHash values over its token set. Movies whose
+//signatures agree on all rows of at least one band land in the same bucket and become a candidate
+//pair. Two sets with Jaccard similarity J collide with probability 1 - (1 - J^rows)^bands, an
+//S-curve whose steep part sits near (1 / bands)^(1 / rows): more rows make the stage more selective,
+//more bands raise recall. Candidates are only likely matches and must be verified exactly
+//(SimilarityGraphBuilder::build_from_candidates does that with calculateSimilarity).
+class MinHashLsh {
+public:
+
+    //Creates a hasher with the given banding.
+    explicit MinHashLsh(size_t bands = 20, size_t rows = 2, uint64_t seed = 1)
+    {
+        bands_ = bands == 0 ? 1 : bands;
+        rows_ = rows == 0 ? 1 : rows;
+        seed_ = seed;
+    }
+
+    //Returns the number of bands.
+    size_t bands() const
+    {
+        return bands_;
+    }
+
+    //Returns the number of rows per band.
+    size_t rows() const
+    {
+        return rows_;
+    }
+
+    //Probability that two sets with the given Jaccard similarity become a candidate pair.
+    double collision_probability(double jaccard) const
+    {
+        double bandMatch = 1.0;
+        for (size_t r = 0; r < rows_; ++r)
+            bandMatch *= jaccard;
+        double miss = 1.0;
+        for (size_t b = 0; b < bands_; ++b)
+            miss *= 1.0 - bandMatch;
+        return 1.0 - miss;
+    }
+
+    //Returns the candidate pairs (i < j, positions in `movies`) in increasing order, each once.
+    std::vector<std::pair<uint32_t, uint32_t>> candidate_pairs(const std::vector<std::pair<int, Movie>>& movies,
+                                                               unsigned numThreads = 0) const
+    {
+        std::vector<std::vector<uint64_t>> tokens(movies.size());
+        for (size_t i = 0; i < movies.size(); ++i)
+            tokens[i] = similarityTokens(movies[i].second);
+        return candidate_pairs(tokens, numThreads);
+    }
+
+    //Same as above for arbitrary token sets.
+    std::vector<std::pair<uint32_t, uint32_t>> candidate_pairs(const std::vector<std::vector<uint64_t>>& tokens,
+                                                               unsigned numThreads = 0) const
+    {
+        const size_t n = tokens.size();
+        ThreadPool pool(numThreads);
+        const size_t chunkCount = pool.size() * 4;
+
+        // Band keys: bandKeys[i * bands + b] hashes the rows of band b of movie i's signature
+        std::vector<uint64_t> bandKeys(n * bands_);
+        pool.parallel_for(chunkCount, [&](size_t chunk, unsigned) {
+            std::vector<uint64_t> signature(bands_ * rows_);
+            for (size_t i = n * chunk / chunkCount; i < n * (chunk + 1) / chunkCount; ++i) {
+                for (size_t h = 0; h < signature.size(); ++h) {
+                    uint64_t minimum = ~0ULL;
+                    for (uint64_t token : tokens[i])
+                        minimum = std::min(minimum, mix(token ^ mix(seed_ + h)));
+                    signature[h] = minimum;
+                }
+                for (size_t b = 0; b < bands_; ++b) {
+                    uint64_t key = mix(seed_ ^ (b + 1));
+                    for (size_t r = 0; r < rows_; ++r)
+                        key = mix(key ^ signature[b * rows_ + r]);
+                    bandKeys[i * bands_ + b] = key;
+                }
+            }
+        });
+
+        // Bucket each band and emit the pairs inside every bucket. A pair is only
+        // emitted by the first band it collides in, so no global dedup is needed.
+        std::vector<std::vector<std::pair<uint32_t, uint32_t>>> perBand(bands_);
+        pool.parallel_for(bands_, [&](size_t band, unsigned) {
+            std::vector<std::pair<uint64_t, uint32_t>> buckets(n);
+            for (size_t i = 0; i < n; ++i)
+                buckets[i] = std::make_pair(bandKeys[i * bands_ + band], static_cast<uint32_t>(i));
+            std::sort(buckets.begin(), buckets.end());
+
+            auto& out = perBand[band];
+            for (size_t first = 0; first < n;) {
+                size_t last = first + 1;
+                while (last < n && buckets[last].first == buckets[first].first)
+                    ++last;
+                for (size_t a = first; a < last; ++a) {
+                    for (size_t b = a + 1; b < last; ++b) {
+                        uint32_t i = buckets[a].second;
+                        uint32_t j = buckets[b].second;
+                        if (!collidedEarlier(bandKeys, i, j, band))
+                            out.emplace_back(i, j);
+                    }
+                }
+                first = last;
+            }
+        });
+
+        size_t total = 0;
+        for (const auto& pairs : perBand)
+            total += pairs.size();
+        std::vector<std::pair<uint32_t, uint32_t>> candidates;
+        candidates.reserve(total);
+        for (auto& pairs : perBand) {
+            candidates.insert(candidates.end(), pairs.begin(), pairs.end());
+            std::vector<std::pair<uint32_t, uint32_t>>().swap(pairs);
+        }
+        std::sort(candidates.begin(), candidates.end());
+        return candidates;
+    }
+
+private:
+
+    //64-bit finalizer (splitmix64) used as the family of MinHash functions.
+    static uint64_t mix(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    //Checks whether two movies already share a bucket in a band before the given one.
+    bool collidedEarlier(const std::vector<uint64_t>& bandKeys, uint32_t i, uint32_t j, size_t band) const
+    {
+        for (size_t b = 0; b < band; ++b) {
+            if (bandKeys[i * bands_ + b] == bandKeys[j * bands_ + b])
+                return true;
+        }
+        return false;
+    }
+
+    size_t bands_;      /**< Number of bands. */
+    size_t rows_;       /**< MinHash values per band. */
+    uint64_t seed_;     /**< Seed of the hash family. */
+};
+
+#endif
@@ -43,6 +43,11 @@ public:
     bool isDisneyPlus() const { return disneyPlus; }
     int getType() const { return type; }
 
+    // Platforms as a bitmask; bit (service - 1) is set when isAvailableOnService(service) is true
+    unsigned getPlatformMask() const {
+        return (netflix ? 1u : 0u) | (primeVideo ? 2u : 0u) | (disneyPlus ? 4u : 0u) | (hulu ? 8u : 0u);
+    }
+
     bool isAvailableOnService(int service) const {
         switch(service) {
             case 1: return netflix;
@@ -0,0 +1,66 @@
+#ifndef MOVIE_FEATURES_HPP
+#define MOVIE_FEATURES_HPP
+
+#include <cstddef>
+#include <string>
+#include "Movie.hpp"
+
+// Dense numeric description of a Movie for vector search. Every component is
+// scaled to [0, 1] so no single feature dominates a Euclidean distance:
+//
+//   [0]     release year, 1900..2025
+//   [1..4]  Netflix, Prime Video, Disney+, Hulu (the getPlatformMask() bits)
+//   [5]     Rotten Tomatoes score ("98/100" -> 0.98)
+//   [6]     age rating ("all" -> 0, "18+" -> 1)
+//   [7]     type (0 movie, 1 TV show)
+//
+// A missing score or rating is placed at the middle of its range.
+const size_t kMovieFeatureCount = 8;
+const int kFeatureMinYear = 1900;
+const int kFeatureMaxYear = 2025;
+
+// Parses a "score/scale" Rotten Tomatoes string into [0, 1], or returns -1
+double parseRottenTomatoes(const std::string& score) {
+    size_t slash = score.find('/');
+    try {
+        double value = std::stod(score.substr(0, slash));
+        double scale = slash == std::string::npos ? 100.0 : std::stod(score.substr(slash + 1));
+        if (scale <= 0.0) return -1.0;
+        double result = value / scale;
+        return result < 0.0 ? 0.0 : (result > 1.0 ? 1.0 : result);
+    } catch (...) {
+        return -1.0;
+    }
+}
+
+// Maps an age rating ("all", "7+", "13+", "16+", "18+") onto [0, 1], or returns -1
+double parseAgeRating(const std::string& age) {
+    if (age == "all") return 0.0;
+    try {
+        double years = std::stod(age);
+        return years <= 0.0 ? 0.0 : (years >= 18.0 ? 1.0 : years / 18.0);
+    } catch (...) {
+        return -1.0;
+    }
+}
+
+// Writes the kMovieFeatureCount features of the movie into out
+void movieFeatures(const Movie& movie, float* out) {
+    double year = static_cast<double>(movie.getYear() - kFeatureMinYear) / (kFeatureMaxYear - kFeatureMinYear);
+    out[0] = static_cast<float>(year < 0.0 ? 0.0 : (year > 1.0 ? 1.0 : year));
+
+    unsigned platforms = movie.getPlatformMask();
+    for (size_t bit = 0; bit < 4; ++bit) {
+        out[1 + bit] = (platforms >> bit) & 1u ? 1.0f : 0.0f;
+    }
+
+    double score = parseRottenTomatoes(movie.getRottenTomatoes());
+    out[5] = static_cast<float>(score < 0.0 ? 0.5 : score);
+
+    double age = parseAgeRating(movie.getAge());
+    out[6] = static_cast<float>(age < 0.0 ? 0.5 : age);
+
+    out[7] = movie.getType() != 0 ? 1.0f : 0.0f;
+}
+
+#endif
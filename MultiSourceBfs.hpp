@@ -0,0 +1,96 @@
+#ifndef MULTI_SOURCE_BFS_HPP
+#define MULTI_SOURCE_BFS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "DirectionOptimizingBfs.hpp"
+#include "ThreadPool.hpp"
+
+// Breadth-first search from many sources at once (MS-BFS, Then et al.).
+// The graph type needs vertex_count() and adjacent(v) returning a range of
+// (neighbor id, weight) pairs.
+//
+// Sources are processed in batches of 64, one bit per source. Every vertex
+// holds three bitsets: which sources have seen it, which have it in their
+// current frontier and which reach it in the next level. When several
+// sources' frontiers meet at a vertex, one scan of its edges expands all of
+// them with a single OR. Like directionOptimizingBfs, each level runs top-down
+// or bottom-up depending on the frontier's edge count. Bottom-up, a vertex
+// stops scanning once every source of the batch has reached it. Batches
+// are independent and run in parallel on the pool.
+//
+// Returns distance[i][v], the hop distance from sources[i] to v, or
+// kUnreachable. Sources out of range reach nothing.
+
+const uint32_t kUnreachable = std::numeric_limits<uint32_t>::max();
+
+template <typename GraphType>
+std::vector<std::vector<uint32_t>> multiSourceBfs(const GraphType& graph, const std::vector<size_t>& sources,
+                                                  ThreadPool& pool) {
+    const size_t n = graph.vertex_count();
+    std::vector<std::vector<uint32_t>> distance(sources.size(), std::vector<uint32_t>(n, kUnreachable));
+
+    size_t totalEdges = 0;
+    for (size_t v = 0; v < n; ++v) totalEdges += graph.adjacent(v).size();
+
+    const size_t batchCount = (sources.size() + 63) / 64;
+    pool.parallel_for(batchCount, [&](size_t batch, unsigned) {
+        const size_t first = batch * 64;
+        const size_t count = std::min<size_t>(64, sources.size() - first);
+
+        // full has a bit for every source seeded, so the bottom-up early exit
+        // does not wait for sources that are out of range
+        std::vector<uint64_t> seen(n, 0), visit(n, 0), next(n, 0);
+        uint64_t full = 0;
+        size_t frontierEdges = 0;
+        for (size_t i = 0; i < count; ++i) {
+            size_t s = sources[first + i];
+            if (s >= n) continue;
+            if (!visit[s]) frontierEdges += graph.adjacent(s).size();
+            seen[s] |= 1ULL << i;
+            visit[s] |= 1ULL << i;
+            full |= 1ULL << i;
+            distance[first + i][s] = 0;
+        }
+
+        for (uint32_t level = 1; frontierEdges > 0; ++level) {
+            if (frontierEdges > totalEdges / kBfsAlpha) {
+                for (size_t v = 0; v < n; ++v) {
+                    if (seen[v] == full) continue;
+                    uint64_t reached = 0;
+                    for (const auto& edge : graph.adjacent(v)) {
+                        reached |= visit[edge.first];
+                        if ((reached | seen[v]) == full) break;
+                    }
+                    next[v] = reached;
+                }
+            } else {
+                for (size_t u = 0; u < n; ++u) {
+                    if (!visit[u]) continue;
+                    for (const auto& edge : graph.adjacent(u)) {
+                        next[edge.first] |= visit[u];
+                    }
+                }
+            }
+
+            frontierEdges = 0;
+            for (size_t v = 0; v < n; ++v) {
+                uint64_t fresh = next[v] & ~seen[v];
+                next[v] = fresh;
+                if (!fresh) continue;
+                seen[v] |= fresh;
+                frontierEdges += graph.adjacent(v).size();
+                for (; fresh; fresh &= fresh - 1) {
+                    distance[first + static_cast<size_t>(__builtin_ctzll(fresh))][v] = level;
+                }
+            }
+            visit.swap(next);
+            std::fill(next.begin(), next.end(), 0);
+        }
+    });
+    return distance;
+}
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef PARALLEL_TRAVERSAL_HPP
+#define PARALLEL_TRAVERSAL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "ThreadPool.hpp"
+
+// Multi-threaded traversals over dense vertex ids. The graph type needs
+// vertex_count() and adjacent(v) returning a range of (neighbor id, weight)
+// pairs; AdjacencyListView adapts a plain vector of adjacency lists.
+
+//Read-only graph view over adjacency lists indexed by vertex id.
+struct AdjacencyListView {
+    const std::vector<std::vector<std::pair<size_t, double>>>& lists;
+
+    size_t vertex_count() const { return lists.size(); }
+    const std::vector<std::pair<size_t, double>>& adjacent(size_t v) const { return lists[v]; }
+};
+
+// Level-synchronous breadth-first search. Each level's frontier is cut into
+// chunks that the pool's threads expand at the same time. A vertex is
+// claimed with an atomic fetch_or on its visited bit, so exactly one thread
+// adds it to the next level. Every thread appends to its own next-frontier
+// buffer, and the buffers are concatenated once the level is done.
+// Returns the reachable vertices level by level, sorted by id within a
+// level so the result does not depend on scheduling.
+template <typename GraphType>
+std::vector<size_t> parallelBfs(const GraphType& graph, size_t source, ThreadPool& pool) {
+    const size_t n = graph.vertex_count();
+    std::vector<size_t> order;
+    if (source >= n) return order;
+
+    const size_t wordCount = (n + 63) / 64;
+    std::unique_ptr<std::atomic<uint64_t>[]> visited(new std::atomic<uint64_t>[wordCount]);
+    for (size_t w = 0; w < wordCount; ++w) visited[w].store(0, std::memory_order_relaxed);
+    visited[source >> 6].store(1ULL << (source & 63), std::memory_order_relaxed);
+
+    std::vector<std::vector<size_t>> buffers(pool.size());
+    std::vector<size_t> frontier(1, source);
+    order.push_back(source);
+
+    while (!frontier.empty()) {
+        const size_t chunkCount = std::min(frontier.size(), static_cast<size_t>(pool.size()) * 8);
+        pool.parallel_for(chunkCount, [&](size_t chunk, unsigned thread) {
+            auto& next = buffers[thread];
+            size_t first = frontier.size() * chunk / chunkCount;
+            size_t last = frontier.size() * (chunk + 1) / chunkCount;
+            for (size_t i = first; i < last; ++i) {
+                for (const auto& edge : graph.adjacent(frontier[i])) {
+                    size_t v = edge.first;
+                    uint64_t bit = 1ULL << (v & 63);
+                    auto& word = visited[v >> 6];
+                    if (word.load(std::memory_order_relaxed) & bit) continue;
+                    if (!(word.fetch_or(bit, std::memory_order_relaxed) & bit)) next.push_back(v);
+                }
+            }
+        });
+
+        frontier.clear();
+        for (auto& next : buffers) {
+            frontier.insert(frontier.end(), next.begin(), next.end());
+            next.clear();
+        }
+        std::sort(frontier.begin(), frontier.end());
+        order.insert(order.end(), frontier.begin(), frontier.end());
+    }
+    return order;
+}
+
+// Connected components with a concurrent union-find. Threads take chunks
+// of vertices and union every vertex with every neighbor it lists, so an
+// edge joins its ends even if only one of them lists it. Roots are linked
+// with compare-and-swap, always the larger root under the smaller one, and
+// finds compress paths by halving. Both steps are safe to run concurrently.
+// A final pass points every vertex at its root, so label[v] is the
+// smallest vertex id in v's component.
+template <typename GraphType>
+std::vector<size_t> parallelConnectedComponents(const GraphType& graph, ThreadPool& pool) {
+    const size_t n = graph.vertex_count();
+    std::unique_ptr<std::atomic<size_t>[]> parent(new std::atomic<size_t>[n]);
+    for (size_t v = 0; v < n; ++v) parent[v].store(v, std::memory_order_relaxed);
+
+    auto find = [&parent](size_t v) {
+        for (;;) {
+            size_t p = parent[v].load(std::memory_order_relaxed);
+            if (p == v) return v;
+            size_t grandparent = parent[p].load(std::memory_order_relaxed);
+            if (grandparent != p) parent[v].compare_exchange_weak(p, grandparent, std::memory_order_relaxed);
+            v = grandparent;
+        }
+    };
+
+    auto unite = [&parent, &find](size_t a, size_t b) {
+        for (;;) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return;
+            if (a < b) std::swap(a, b);
+            size_t expected = a;
+            if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) return;
+        }
+    };
+
+    const size_t chunkCount = std::min(n, static_cast<size_t>(pool.size()) * 16);
+    pool.parallel_for(chunkCount, [&](size_t chunk, unsigned) {
+        for (size_t v = n * chunk / chunkCount; v < n * (chunk + 1) / chunkCount; ++v) {
+            for (const auto& edge : graph.adjacent(v)) {
+                if (edge.first != v) unite(v, edge.first);
+            }
+        }
+    });
+
+    std::vector<size_t> label(n);
+    pool.parallel_for(chunkCount, [&](size_t chunk, unsigned) {
+        for (size_t v = n * chunk / chunkCount; v < n * (chunk + 1) / chunkCount; ++v) {
+            label[v] = find(v);
+        }
+    });
+    return label;
+}
+
+#endif
@@ -0,0 +1,293 @@
+#ifndef PERSONALIZED_PAGE_RANK_HPP
+#define PERSONALIZED_PAGE_RANK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "ThreadPool.hpp"
+
+// Affinity of an edge of the similarity graph, whose weights are
+// 1 - similarity: the similarity itself.
+inline double similarityAffinity(double weight) {
+    return std::max(0.0, 1.0 - weight);
+}
+
+// Number of random walks after which every Monte-Carlo score is within
+// `tolerance` of its true value with probability 1 - failureProbability
+// (Hoeffding bound).
+inline size_t walksForTolerance(double tolerance, double failureProbability = 0.01) {
+    return static_cast<size_t>(std::ceil(std::log(2.0 / failureProbability) / (2.0 * tolerance * tolerance)));
+}
+
+//Class that defines a personalized PageRank (random walk with restart) engine over a weighted graph.
+//
+//A walk starts at a seed vertex, stops with probability alpha at every step, and otherwise moves to
+//a neighbor chosen with probability proportional to the edge's affinity (by default the similarity
+//1 - weight). The score of a vertex is the probability that the walk stops there, so vertices
+//that are close to the seeds along many strong edges rank highest. A walk at a vertex without
+//positive affinities restarts from the seeds.
+//
+//forward_push computes scores deterministically by pushing residual probability mass. It stops
+//when every vertex's residual is below tolerance * degree, which bounds the error of each score
+//by the same amount (so dense graphs need a small tolerance), and is the fast choice for a single
+//query. monte_carlo samples walks in
+//parallel, picking each step in O(1) from per-vertex alias tables; use walksForTolerance to size
+//it. Both take an optional latency budget and return the best estimate available when it runs out.
+//Both return the top-k vertex ids with scores, best first, excluding the seeds.
+class PersonalizedPageRank {
+public:
+
+    //Copies the graph's adjacency into transition and alias tables. The graph type needs
+    //vertex_count() and adjacent(v) returning (neighbor id, weight) pairs.
+    template <typename GraphType>
+    explicit PersonalizedPageRank(const GraphType& graph,
+                                  const std::function<double(double)>& affinity = similarityAffinity)
+    {
+        const size_t n = graph.vertex_count();
+        offsets_.assign(n + 1, 0);
+        for (size_t v = 0; v < n; ++v) {
+            size_t positive = 0;
+            for (const auto& edge : graph.adjacent(v)) {
+                if (affinity(edge.second) > 0.0) ++positive;
+            }
+            offsets_[v + 1] = offsets_[v] + positive;
+        }
+
+        targets_.resize(offsets_[n]);
+        transition_.resize(offsets_[n]);
+        aliasThreshold_.resize(offsets_[n]);
+        alias_.resize(offsets_[n]);
+        std::vector<double> weights;
+        for (size_t v = 0; v < n; ++v) {
+            weights.clear();
+            size_t i = offsets_[v];
+            for (const auto& edge : graph.adjacent(v)) {
+                double a = affinity(edge.second);
+                if (a <= 0.0) continue;
+                targets_[i++] = static_cast<uint32_t>(edge.first);
+                weights.push_back(a);
+            }
+            buildAliasTable(offsets_[v], weights);
+        }
+    }
+
+    //Returns the number of vertices.
+    size_t vertex_count() const
+    {
+        return offsets_.size() - 1;
+    }
+
+    //Scores by forward push from the seeds (each seed gets an equal share of the restart mass).
+    std::vector<std::pair<size_t, double>> forward_push(const std::vector<size_t>& seeds, size_t k,
+                                                        double tolerance = 1e-6, double alpha = 0.15,
+                                                        double budgetSeconds = 0.0) const
+    {
+        const size_t n = vertex_count();
+        std::vector<size_t> start = validSeeds(seeds);
+        std::vector<double> score(n, 0.0), residual(n, 0.0);
+        if (start.empty())
+            return {};
+
+        const auto deadline = deadlineAfter(budgetSeconds);
+        std::deque<size_t> queue;
+        std::vector<char> queued(n, 0);
+        auto enqueue = [&](size_t v) {
+            if (!queued[v] && residual[v] > tolerance * std::max<size_t>(1, degree(v))) {
+                queued[v] = 1;
+                queue.push_back(v);
+            }
+        };
+        for (size_t s : start)
+            residual[s] += 1.0 / start.size();
+        for (size_t s : start)
+            enqueue(s);
+
+        for (size_t pushes = 0; !queue.empty(); ++pushes) {
+            if (budgetSeconds > 0.0 && (pushes & 255) == 0 && std::chrono::steady_clock::now() > deadline)
+                break;
+            size_t u = queue.front();
+            queue.pop_front();
+            queued[u] = 0;
+
+            double mass = residual[u];
+            residual[u] = 0.0;
+            score[u] += alpha * mass;
+            double spread = (1.0 - alpha) * mass;
+            if (degree(u) == 0) {
+                for (size_t s : start) {
+                    residual[s] += spread / start.size();
+                    enqueue(s);
+                }
+                continue;
+            }
+            for (size_t i = offsets_[u]; i < offsets_[u + 1]; ++i) {
+                residual[targets_[i]] += spread * transition_[i];
+                enqueue(targets_[i]);
+            }
+        }
+        // Every walk still holding residual mass stops where it is with probability
+        // alpha, so adding that share keeps the scores lower bounds and tightens them
+        for (size_t v = 0; v < n; ++v)
+            score[v] += alpha * residual[v];
+        return topK(score, start, k);
+    }
+
+    //Scores by sampling `walks` random walks on every thread of a pool (0 threads uses every core).
+    std::vector<std::pair<size_t, double>> monte_carlo(const std::vector<size_t>& seeds, size_t k, size_t walks,
+                                                       double alpha = 0.15, unsigned numThreads = 0,
+                                                       double budgetSeconds = 0.0, uint64_t seed = 1) const
+    {
+        const size_t n = vertex_count();
+        std::vector<size_t> start = validSeeds(seeds);
+        if (start.empty() || walks == 0)
+            return {};
+
+        ThreadPool pool(numThreads);
+        const auto deadline = deadlineAfter(budgetSeconds);
+        const size_t chunkSize = 4096;
+        const size_t chunkCount = (walks + chunkSize - 1) / chunkSize;
+        std::vector<std::vector<uint32_t>> stops(pool.size(), std::vector<uint32_t>(n, 0));
+        std::vector<size_t> completed(pool.size(), 0);
+        const uint64_t continueBelow = static_cast<uint64_t>((1.0 - alpha) * 18446744073709551615.0);
+
+        pool.parallel_for(chunkCount, [&](size_t chunk, unsigned thread) {
+            if (budgetSeconds > 0.0 && std::chrono::steady_clock::now() > deadline)
+                return;
+            uint64_t state = seed ^ (0x9E3779B97F4A7C15ULL * (chunk + 1));
+            size_t first = chunk * chunkSize;
+            size_t last = std::min(walks, first + chunkSize);
+            for (size_t w = first; w < last; ++w) {
+                size_t v = start[w % start.size()];
+                while (next(state) < continueBelow) {
+                    if (degree(v) == 0) {
+                        v = start[next(state) % start.size()];
+                        continue;
+                    }
+                    v = sampleNeighbor(v, next(state));
+                }
+                ++stops[thread][v];
+            }
+            completed[thread] += last - first;
+        });
+
+        size_t total = 0;
+        for (size_t c : completed)
+            total += c;
+        std::vector<double> score(n, 0.0);
+        if (total == 0)
+            return {};
+        for (const auto& counts : stops) {
+            for (size_t v = 0; v < n; ++v)
+                score[v] += static_cast<double>(counts[v]) / total;
+        }
+        return topK(score, start, k);
+    }
+
+private:
+
+    size_t degree(size_t v) const
+    {
+        return offsets_[v + 1] - offsets_[v];
+    }
+
+    //Builds the transition probabilities and the alias table of one vertex (Vose's method).
+    void buildAliasTable(size_t first, const std::vector<double>& weights)
+    {
+        const size_t d = weights.size();
+        double total = 0.0;
+        for (double w : weights)
+            total += w;
+
+        std::vector<double> scaled(d);
+        std::vector<size_t> small, large;
+        for (size_t i = 0; i < d; ++i) {
+            transition_[first + i] = static_cast<float>(weights[i] / total);
+            scaled[i] = weights[i] / total * d;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+        while (!small.empty() && !large.empty()) {
+            size_t s = small.back(), l = large.back();
+            small.pop_back();
+            aliasThreshold_[first + s] = static_cast<float>(scaled[s]);
+            alias_[first + s] = static_cast<uint32_t>(l);
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        for (size_t i : small) {
+            aliasThreshold_[first + i] = 1.0f;
+            alias_[first + i] = static_cast<uint32_t>(i);
+        }
+        for (size_t i : large) {
+            aliasThreshold_[first + i] = 1.0f;
+            alias_[first + i] = static_cast<uint32_t>(i);
+        }
+    }
+
+    //Picks a neighbor of v with probability proportional to its affinity from 64 random bits.
+    size_t sampleNeighbor(size_t v, uint64_t bits) const
+    {
+        size_t i = offsets_[v] + static_cast<size_t>((bits >> 32) * degree(v) >> 32);
+        float coin = static_cast<float>(bits & 0xFFFFFF) / 16777216.0f;
+        return targets_[coin < aliasThreshold_[i] ? i : offsets_[v] + alias_[i]];
+    }
+
+    //splitmix64 step.
+    static uint64_t next(uint64_t& state)
+    {
+        uint64_t x = (state += 0x9E3779B97F4A7C15ULL);
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    static std::chrono::steady_clock::time_point deadlineAfter(double seconds)
+    {
+        return std::chrono::steady_clock::now() +
+               std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+    }
+
+    std::vector<size_t> validSeeds(const std::vector<size_t>& seeds) const
+    {
+        std::vector<size_t> valid;
+        for (size_t s : seeds) {
+            if (s < vertex_count()) valid.push_back(s);
+        }
+        return valid;
+    }
+
+    //Returns the k best-scoring vertices that are not seeds, best first (ties by id).
+    static std::vector<std::pair<size_t, double>> topK(const std::vector<double>& score,
+                                                       const std::vector<size_t>& seeds, size_t k)
+    {
+        std::vector<char> isSeed(score.size(), 0);
+        for (size_t s : seeds)
+            isSeed[s] = 1;
+        std::vector<std::pair<size_t, double>> ranked;
+        for (size_t v = 0; v < score.size(); ++v) {
+            if (!isSeed[v] && score[v] > 0.0) ranked.emplace_back(v, score[v]);
+        }
+        auto better = [](const std::pair<size_t, double>& a, const std::pair<size_t, double>& b) {
+            return a.second != b.second ? a.second > b.second : a.first < b.first;
+        };
+        k = std::min(k, ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + k, ranked.end(), better);
+        ranked.resize(k);
+        return ranked;
+    }
+
+    std::vector<size_t> offsets_;           /**< Start of every vertex's transitions. */
+    std::vector<uint32_t> targets_;         /**< Neighbor ids with positive affinity. */
+    std::vector<float> transition_;         /**< Transition probability to each neighbor. */
+    std::vector<float> aliasThreshold_;     /**< Alias method: keep slot i if the coin is below this. */
+    std::vector<uint32_t> alias_;           /**< Alias method: otherwise take this slot. */
+};
+
+#endif
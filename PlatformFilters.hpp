@@ -0,0 +1,82 @@
+#ifndef PLATFORM_FILTERS_HPP
+#define PLATFORM_FILTERS_HPP
+
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+#include "Bitmap.hpp"
+#include "Movie.hpp"
+#include "WeightedUndirectedGraph.hpp"
+
+//Class that defines one vertex bitmap per streaming service, to restrict traversals to the
+//movies a subscriber can watch.
+//
+//Services are numbered as in Movie::isAvailableOnService: 1 Netflix, 2 Prime Video, 3 Disney+,
+//4 Hulu. Bit v of a service's bitmap is set when the movie with vertex id v is available on it.
+//The bitmaps combine with & and |: any_of({1, 4}) allows movies on Netflix or Hulu, and
+//all_of({1, 2}) movies on both. They index vertex ids, so rebuild them after vertices are added,
+//removed or reordered: filtered traversals reject a bitmap whose size is not the graph's vertex
+//count, and built_for() tells whether the filters still fit a graph, reorders included.
+//Default-constructed filters are empty and fit only a new, empty graph.
+class PlatformFilters {
+public:
+    static constexpr int kServiceCount = 4;
+
+    PlatformFilters() = default;
+
+    //Marks the vertex of every movie (looked up by title) in the bitmaps of its services.
+    PlatformFilters(const std::vector<std::pair<int, Movie>>& movies, const Graph& graph)
+        : graphVersion_(graph.version())
+    {
+        for (int service = 1; service <= kServiceCount; ++service)
+            services_[service - 1] = Bitmap(graph.vertex_count());
+        for (const auto& moviePair : movies) {
+            size_t v = graph.vertex_id(moviePair.second.getTitle());
+            if (v == Graph::npos) continue;
+            for (int service = 1; service <= kServiceCount; ++service) {
+                if (moviePair.second.isAvailableOnService(service))
+                    services_[service - 1].set(v);
+            }
+        }
+    }
+
+    //Returns whether the bitmaps were built from the graph as it is now (same vertex count, and
+    //no vertex or edge changed and no reorder since).
+    bool built_for(const Graph& graph) const
+    {
+        return services_[0].size() == graph.vertex_count() && graphVersion_ == graph.version();
+    }
+
+    //Returns the movies available on a service (1 to kServiceCount).
+    const Bitmap& service(int service) const
+    {
+        return services_[service - 1];
+    }
+
+    //Returns the movies available on at least one of the services.
+    Bitmap any_of(std::initializer_list<int> services) const
+    {
+        Bitmap allowed(services_[0].size());
+        for (int s : services)
+            allowed |= service(s);
+        return allowed;
+    }
+
+    //Returns the movies available on every one of the services (every movie if none is given).
+    Bitmap all_of(std::initializer_list<int> services) const
+    {
+        Bitmap allowed(services_[0].size());
+        for (size_t v = 0; v < allowed.size(); ++v)
+            allowed.set(v);
+        for (int s : services)
+            allowed &= service(s);
+        return allowed;
+    }
+
+private:
+    Bitmap services_[kServiceCount];   /**< Movies available on each service. */
+    uint64_t graphVersion_ = 0;        /**< version() of the graph the bitmaps index. */
+};
+
+#endif
@@ -0,0 +1,284 @@
+#ifndef SHORTEST_PATH_HPP
+#define SHORTEST_PATH_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "TraversalContext.hpp"
+
+//Class that defines a monotone radix heap of (distance, vertex id) entries.
+//
+//Dijkstra only ever pops keys that are no smaller than the last key popped, which lets a radix
+//heap replace a binary heap: entries live in 65 buckets by the highest bit in which their key
+//differs from the last popped key, and a pop only redistributes the first non-empty bucket.
+//Distances must be non-negative; their IEEE-754 bit patterns then order like the doubles themselves
+//and serve as the integer keys. There is no decrease-key: push the vertex again and skip stale
+//entries on pop.
+class RadixHeap {
+public:
+
+    //Checks if the heap is empty.
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    //Removes every entry and resets the last popped key.
+    void clear()
+    {
+        for (auto& bucket : buckets_)
+            bucket.clear();
+        size_ = 0;
+        last_ = 0;
+    }
+
+    //Adds a vertex with a distance no smaller than the last popped one.
+    void push(double distance, uint32_t vertex)
+    {
+        uint64_t key = keyOf(distance);
+        buckets_[bucketOf(key)].emplace_back(key, vertex);
+        ++size_;
+    }
+
+    //Returns the smallest distance in the heap.
+    double top_distance()
+    {
+        settle();
+        return distanceOf(buckets_[0].back().first);
+    }
+
+    //Removes and returns the entry with the smallest distance.
+    std::pair<double, uint32_t> pop()
+    {
+        settle();
+        auto entry = buckets_[0].back();
+        buckets_[0].pop_back();
+        --size_;
+        return std::make_pair(distanceOf(entry.first), entry.second);
+    }
+
+private:
+
+    static uint64_t keyOf(double distance)
+    {
+        uint64_t key;
+        std::memcpy(&key, &distance, sizeof(key));
+        return key;
+    }
+
+    static double distanceOf(uint64_t key)
+    {
+        double distance;
+        std::memcpy(&distance, &key, sizeof(distance));
+        return distance;
+    }
+
+    //Bucket 0 holds keys equal to the last popped key; bucket b holds keys whose highest bit
+    //differing from it is bit b - 1.
+    size_t bucketOf(uint64_t key) const
+    {
+        uint64_t diff = key ^ last_;
+        return diff == 0 ? 0 : 64 - static_cast<size_t>(__builtin_clzll(diff));
+    }
+
+    //Makes bucket 0 non-empty by redistributing the first non-empty bucket around its minimum.
+    void settle()
+    {
+        if (!buckets_[0].empty())
+            return;
+        size_t b = 1;
+        while (buckets_[b].empty())
+            ++b;
+        uint64_t minimum = buckets_[b][0].first;
+        for (const auto& entry : buckets_[b])
+            minimum = std::min(minimum, entry.first);
+        last_ = minimum;
+        for (const auto& entry : buckets_[b])
+            buckets_[bucketOf(entry.first)].push_back(entry);
+        buckets_[b].clear();
+    }
+
+    std::vector<std::pair<uint64_t, uint32_t>> buckets_[65];  /**< Entries grouped by key prefix. */
+    size_t size_ = 0;                                       /**< Number of entries. */
+    uint64_t last_ = 0;                                     /**< Last popped key. */
+};
+
+// Minimal-weight distance from a source vertex id to every vertex id with
+// Dijkstra (infinity where unreachable). Same graph requirements as below.
+template <typename GraphType>
+std::vector<double> dijkstraDistances(const GraphType& graph, size_t source) {
+    const size_t n = graph.vertex_count();
+    std::vector<double> dist(n, std::numeric_limits<double>::infinity());
+    if (source >= n) return dist;
+
+    std::vector<char> settled(n, 0);
+    RadixHeap heap;
+    dist[source] = 0.0;
+    heap.push(0.0, static_cast<uint32_t>(source));
+    while (!heap.empty()) {
+        auto entry = heap.pop();
+        uint32_t u = entry.second;
+        if (settled[u]) continue;
+        settled[u] = 1;
+        for (const auto& edge : graph.adjacent(u)) {
+            double candidate = entry.first + edge.second;
+            if (candidate < dist[edge.first]) {
+                dist[edge.first] = candidate;
+                heap.push(candidate, static_cast<uint32_t>(edge.first));
+            }
+        }
+    }
+    return dist;
+}
+
+// Minimal-weight path between two vertex ids with bidirectional Dijkstra.
+// The graph type needs vertex_count() and adjacent(v) returning a range of
+// (neighbor id, weight) pairs; weights must be non-negative. Both searches
+// advance alternately, always expanding the side with the smaller frontier
+// key, and stop once the two frontier keys together reach the best meeting
+// distance found so far: no unexplored path can be shorter than that.
+// On success `path` holds the vertex ids from source to target.
+template <typename GraphType>
+bool bidirectionalDijkstra(const GraphType& graph, size_t source, size_t target,
+                           std::vector<size_t>& path, double& distance) {
+    const size_t n = graph.vertex_count();
+    const double infinity = std::numeric_limits<double>::infinity();
+    const uint32_t none = std::numeric_limits<uint32_t>::max();
+    path.clear();
+    if (source >= n || target >= n) return false;
+    if (source == target) {
+        path.push_back(source);
+        distance = 0.0;
+        return true;
+    }
+
+    // Side 0 searches forward from the source, side 1 backward from the target
+    std::vector<double> dist[2] = { std::vector<double>(n, infinity), std::vector<double>(n, infinity) };
+    std::vector<uint32_t> parent[2] = { std::vector<uint32_t>(n, none), std::vector<uint32_t>(n, none) };
+    std::vector<char> settled[2] = { std::vector<char>(n, 0), std::vector<char>(n, 0) };
+    RadixHeap heap[2];
+
+    dist[0][source] = 0.0;
+    dist[1][target] = 0.0;
+    heap[0].push(0.0, static_cast<uint32_t>(source));
+    heap[1].push(0.0, static_cast<uint32_t>(target));
+
+    double best = infinity;
+    uint32_t meeting = none;
+
+    while (!heap[0].empty() && !heap[1].empty()) {
+        double top0 = heap[0].top_distance();
+        double top1 = heap[1].top_distance();
+        if (top0 + top1 >= best) break;
+
+        int side = top0 <= top1 ? 0 : 1;
+        auto entry = heap[side].pop();
+        uint32_t u = entry.second;
+        if (settled[side][u] || entry.first > dist[side][u]) continue;
+        settled[side][u] = 1;
+
+        for (const auto& edge : graph.adjacent(u)) {
+            size_t v = edge.first;
+            double candidate = entry.first + edge.second;
+            if (candidate < dist[side][v]) {
+                dist[side][v] = candidate;
+                parent[side][v] = u;
+                heap[side].push(candidate, static_cast<uint32_t>(v));
+            }
+            double through = dist[side][v] + dist[1 - side][v];
+            if (through < best) {
+                best = through;
+                meeting = static_cast<uint32_t>(v);
+            }
+        }
+    }
+
+    if (meeting == none) return false;
+
+    for (uint32_t v = meeting; v != none; v = parent[0][v])
+        path.push_back(v);
+    std::reverse(path.begin(), path.end());
+    for (uint32_t v = parent[1][meeting]; v != none; v = parent[1][v])
+        path.push_back(v);
+    distance = best;
+    return true;
+}
+
+// The k vertices with the smallest path weight from a source over paths of
+// at most maxHops edges, nearest first as (vertex id, distance) pairs; among
+// vertices tied at the k-th distance the first ones found are kept, and the
+// source itself is not listed. Every adjacency
+// list must be sorted by ascending weight (Graph::sort_adjacency_by_weight),
+// and weights must be non-negative.
+//
+// The search is best-first, but an expanded vertex does not push all of its
+// neighbors: it pushes one cursor into its sorted list, keyed by the
+// distance through its next neighbor, and popping the cursor emits that
+// neighbor and advances it. The heap therefore holds one entry per expanded
+// vertex, and a query stops as soon as the k-th result is closer than every
+// key left on the heap, usually after touching a few lists' first entries.
+// Keys come off the heap in ascending order, so results arrive sorted and
+// the search ends at the k-th one.
+// Hop limits make one vertex reachable along paths that trade weight for
+// hops, so a settled vertex is expanded again when reached with fewer hops;
+// the context's parent slot holds the fewest hops it was expanded with.
+template <typename GraphType>
+std::vector<std::pair<size_t, double>> topKWithinHops(const GraphType& graph, size_t source, size_t k,
+                                                      size_t maxHops, TraversalContext& context) {
+    std::vector<std::pair<size_t, double>> result;
+    if (source >= graph.vertex_count() || k == 0 || maxHops == 0) return result;
+
+    struct Cursor {
+        double key;         // distance through the neighbor at `index`
+        double base;        // distance of `vertex`
+        uint32_t vertex;
+        uint32_t index;
+        uint32_t hops;      // edges from the source to `vertex`
+
+        bool operator<(const Cursor& other) const {
+            return key > other.key;
+        }
+    };
+    std::vector<Cursor> heap;
+    auto expand = [&](size_t v, double distance, uint32_t hops) {
+        const auto& list = graph.adjacent(v);
+        if (hops >= maxHops || list.size() == 0) return;
+        heap.push_back({ distance + list[0].second, distance, static_cast<uint32_t>(v), 0, hops });
+        std::push_heap(heap.begin(), heap.end());
+    };
+
+    context.reset(graph.vertex_count());
+    context.visit(source);
+    context.set_parent(source, 0);
+    expand(source, 0.0, 0);
+    while (!heap.empty() && result.size() < k) {
+        Cursor cursor = heap.front();
+        std::pop_heap(heap.begin(), heap.end());
+        const auto& list = graph.adjacent(cursor.vertex);
+        size_t u = list[cursor.index].first;
+        if (cursor.index + 1 < list.size()) {
+            heap.back().index = cursor.index + 1;
+            heap.back().key = cursor.base + list[cursor.index + 1].second;
+            std::push_heap(heap.begin(), heap.end());
+        } else {
+            heap.pop_back();
+        }
+
+        uint32_t hops = cursor.hops + 1;
+        if (context.visited(u)) {
+            // Reached before at no greater distance; only fewer hops make it worth expanding again
+            if (context.parent(u) <= hops) continue;
+        } else {
+            context.visit(u);
+            result.emplace_back(u, cursor.key);
+        }
+        context.set_parent(u, hops);
+        expand(u, cursor.key, hops);
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,364 @@
+#ifndef SIMILARITY_GRAPH_BUILDER_HPP
+#define SIMILARITY_GRAPH_BUILDER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Movie.hpp"
+#include "SimilarityKernel.hpp"
+#include "ThreadPool.hpp"
+#include "ThresholdGraph.hpp"
+#include "WeightedUndirectedGraph.hpp"
+
+// Builds the similarity graph of Step3/Step4 on a thread pool.
+//
+// Pairs are scored with the SIMD batch kernel from SimilarityKernel.hpp,
+// which gives exactly the calculateSimilarity values.
+//
+// The pairwise loop over (i, j > i) is cut into one block of consecutive rows
+// per thread, sized so every block holds about the same number of pairs. Each
+// block collects its edges in its own buffer, so scoring never touches shared
+// state. The buffers are then scattered into the final adjacency lists in one
+// parallel pass: per-block degree counts are turned into per-block write
+// offsets, so every block writes a disjoint slice of each list and no locking
+// is needed. The offsets follow block order, which reproduces exactly the
+// neighbor order the sequential add_edge loop produces.
+class SimilarityGraphBuilder {
+public:
+    explicit SimilarityGraphBuilder(double similarityThreshold = 0.5, unsigned numThreads = 0)
+        : similarityThreshold_(similarityThreshold), numThreads_(numThreads) {}
+
+    // Adds every movie as a vertex (in the given order) and replaces the
+    // graph's edges with one edge of weight 1 - similarity per pair whose
+    // calculateSimilarity is at least the threshold.
+    void build(const vector<pair<int, Movie>>& movies, Graph& graph) const {
+        const vector<uint32_t> ids = addVertices(movies, graph);
+
+        ThreadPool pool(numThreads_);
+        const size_t blockCount = pool.size();
+        const vector<size_t> rows = triangularBlocks(movies.size(), blockCount);
+
+        // Every similarity is k / 5 for k matching features, so the threshold
+        // test and the weight are looked up per match count
+        const PackedMovieColumns columns(movies);
+        bool passes[6];
+        double weights[6];
+        for (uint8_t k = 0; k <= 5; ++k) {
+            double similarity = similarityFromMatches(k);
+            passes[k] = similarity >= similarityThreshold_;
+            weights[k] = 1.0 - similarity;
+        }
+
+        // Score every pair with the batch kernel; each block only appends to its own buffer
+        vector<vector<PendingEdge>> buffers(blockCount);
+        pool.parallel_for(blockCount, [&](size_t block, unsigned) {
+            auto& buffer = buffers[block];
+            vector<uint8_t> matches(movies.size());
+            for (size_t i = rows[block]; i < rows[block + 1]; ++i) {
+                const size_t count = movies.size() - i - 1;
+                columns.match_counts(i, i + 1, count, matches.data());
+                for (size_t k = 0; k < count; ++k) {
+                    if (passes[matches[k]]) {
+                        buffer.push_back({ ids[i], ids[i + 1 + k], weights[matches[k]] });
+                    }
+                }
+            }
+        });
+
+        graph.set_adjacency(scatter(buffers, graph.vertex_count(), pool));
+    }
+
+    // Builds the graph from a candidate list instead of every pair: each
+    // candidate (positions in `movies`, as produced by MinHashLsh) is checked
+    // with calculateSimilarity and becomes an edge when it clears the
+    // threshold. Pairs that are not candidates are never scored, so the graph
+    // holds the subset of the exact threshold graph the candidates cover.
+    void build_from_candidates(const vector<pair<int, Movie>>& movies, Graph& graph,
+                               const vector<pair<uint32_t, uint32_t>>& candidates) const {
+        const vector<uint32_t> ids = addVertices(movies, graph);
+
+        ThreadPool pool(numThreads_);
+        const size_t blockCount = pool.size();
+        vector<vector<PendingEdge>> buffers(blockCount);
+        pool.parallel_for(blockCount, [&](size_t block, unsigned) {
+            auto& buffer = buffers[block];
+            size_t first = candidates.size() * block / blockCount;
+            size_t last = candidates.size() * (block + 1) / blockCount;
+            for (size_t c = first; c < last; ++c) {
+                const auto& pair = candidates[c];
+                double similarity = calculateSimilarity(movies[pair.first].second, movies[pair.second].second);
+                if (similarity >= similarityThreshold_) {
+                    buffer.push_back({ ids[pair.first], ids[pair.second], 1.0 - similarity });
+                }
+            }
+        });
+
+        graph.set_adjacency(scatter(buffers, graph.vertex_count(), pool));
+    }
+
+    // k-nearest-neighbor mode: each movie keeps only its k most similar
+    // movies among those at or above the threshold, so the graph holds at
+    // most 2 * n * k entries however dense the catalog is. Candidates are
+    // ranked by similarity, ties going to the movie that comes first in
+    // `movies`, so the result does not depend on the thread count.
+    //
+    // An edge is kept when either end selected it, so every edge is listed
+    // at both ends as Graph requires; degrees are at least k (given enough
+    // movies above the threshold) but can exceed it. Lists are ordered from
+    // most to least similar.
+    void build_nearest_neighbors(const vector<pair<int, Movie>>& movies, Graph& graph, size_t k) const {
+        const vector<uint32_t> ids = addVertices(movies, graph);
+        const size_t n = movies.size();
+
+        ThreadPool pool(numThreads_);
+        const PackedMovieColumns columns(movies);
+        uint8_t minMatches = 6;
+        for (uint8_t m = 0; m <= 5 && minMatches == 6; ++m) {
+            if (similarityFromMatches(m) >= similarityThreshold_) minMatches = m;
+        }
+
+        // Top k of every movie, by position in `movies`, best first
+        vector<vector<Candidate>> nearest(n);
+        const size_t chunkCount = pool.size() * 8;
+        pool.parallel_for(chunkCount, [&](size_t chunk, unsigned) {
+            vector<uint8_t> matches(n);
+            vector<Candidate> heap;
+            for (size_t i = n * chunk / chunkCount; i < n * (chunk + 1) / chunkCount; ++i) {
+                columns.match_counts(i, 0, n, matches.data());
+                heap.clear();
+                for (size_t j = 0; j < n && k > 0; ++j) {
+                    if (j == i || matches[j] < minMatches) continue;
+                    Candidate c = { matches[j], static_cast<uint32_t>(j) };
+                    if (heap.size() < k) {
+                        heap.push_back(c);
+                        std::push_heap(heap.begin(), heap.end());
+                    } else if (c < heap.front()) {
+                        std::pop_heap(heap.begin(), heap.end());
+                        heap.back() = c;
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                }
+                std::sort_heap(heap.begin(), heap.end());
+                nearest[i] = heap;
+            }
+        });
+
+        // A later movie with a duplicate title shares the vertex of the first one
+        vector<vector<pair<size_t, double>>> adjacency(graph.vertex_count());
+        vector<vector<Candidate>> selected(graph.vertex_count());
+        for (size_t i = 0; i < n; ++i) {
+            for (const auto& c : nearest[i]) {
+                selected[ids[i]].push_back({ c.matches, ids[c.index] });
+            }
+        }
+
+        // Mirror every selection
+        vector<size_t> ownCount(selected.size());
+        for (size_t v = 0; v < selected.size(); ++v) {
+            ownCount[v] = selected[v].size();
+        }
+        for (size_t v = 0; v < selected.size(); ++v) {
+            for (size_t e = 0; e < ownCount[v]; ++e) {
+                Candidate c = selected[v][e];
+                selected[c.index].push_back({ c.matches, static_cast<uint32_t>(v) });
+            }
+        }
+
+        pool.parallel_for(chunkCount, [&](size_t chunk, unsigned) {
+            const size_t vertexCount = selected.size();
+            for (size_t v = vertexCount * chunk / chunkCount; v < vertexCount * (chunk + 1) / chunkCount; ++v) {
+                auto& list = selected[v];
+                std::sort(list.begin(), list.end());
+                list.erase(std::unique(list.begin(), list.end()), list.end());
+                adjacency[v].reserve(list.size());
+                for (const auto& c : list) {
+                    if (c.index != v) {
+                        adjacency[v].emplace_back(c.index, 1.0 - similarityFromMatches(c.matches));
+                    }
+                }
+                vector<Candidate>().swap(list);
+            }
+        });
+
+        graph.set_adjacency(std::move(adjacency));
+    }
+
+    // Threshold-sweep mode: adds every movie as a vertex (the graph gets no
+    // edges) and returns every pair at or above the threshold as a
+    // ThresholdGraph, each list sorted from most to least similar. Build it
+    // at the lowest threshold of interest; any higher threshold is then a
+    // query instead of a rebuild.
+    ThresholdGraph build_threshold_graph(const vector<pair<int, Movie>>& movies, Graph& graph) const {
+        const vector<uint32_t> ids = addVertices(movies, graph);
+        const size_t n = movies.size();
+        const size_t vertexCount = graph.vertex_count();
+
+        ThreadPool pool(numThreads_);
+        const PackedMovieColumns columns(movies);
+        uint8_t minMatches = 6;
+        for (uint8_t m = 0; m <= 5 && minMatches == 6; ++m) {
+            if (similarityFromMatches(m) >= similarityThreshold_) minMatches = m;
+        }
+        float similarities[6];
+        for (uint8_t k = 0; k <= 5; ++k) {
+            similarities[k] = static_cast<float>(similarityFromMatches(k));
+        }
+
+        // Movies of every vertex (more than one when titles repeat)
+        vector<vector<uint32_t>> moviesOf(vertexCount);
+        for (size_t i = 0; i < n; ++i) {
+            moviesOf[ids[i]].push_back(static_cast<uint32_t>(i));
+        }
+
+        // Every chunk of vertices fills its own entries; a neighbor reached
+        // through several movies keeps its best similarity
+        const size_t chunkCount = pool.size() * 8;
+        vector<vector<ThresholdGraph::Entry>> chunkEntries(chunkCount);
+        vector<uint64_t> offsets(vertexCount + 1, 0);
+        pool.parallel_for(chunkCount, [&](size_t chunk, unsigned) {
+            vector<uint8_t> matches(n);
+            vector<Candidate> candidates;
+            vector<uint32_t> seenBy(vertexCount, 0);
+            auto& entries = chunkEntries[chunk];
+            for (size_t v = vertexCount * chunk / chunkCount; v < vertexCount * (chunk + 1) / chunkCount; ++v) {
+                candidates.clear();
+                for (uint32_t i : moviesOf[v]) {
+                    columns.match_counts(i, 0, n, matches.data());
+                    for (size_t j = 0; j < n; ++j) {
+                        if (matches[j] >= minMatches && ids[j] != v) {
+                            candidates.push_back({ matches[j], ids[j] });
+                        }
+                    }
+                }
+                std::sort(candidates.begin(), candidates.end());
+                size_t degree = 0;
+                for (const auto& c : candidates) {
+                    if (seenBy[c.index] == v + 1) continue;
+                    seenBy[c.index] = static_cast<uint32_t>(v + 1);
+                    entries.emplace_back(c.index, similarities[c.matches]);
+                    ++degree;
+                }
+                offsets[v + 1] = degree;
+            }
+        });
+
+        for (size_t v = 0; v < vertexCount; ++v) {
+            offsets[v + 1] += offsets[v];
+        }
+        vector<ThresholdGraph::Entry> entries;
+        entries.reserve(offsets[vertexCount]);
+        for (auto& chunk : chunkEntries) {
+            entries.insert(entries.end(), chunk.begin(), chunk.end());
+            vector<ThresholdGraph::Entry>().swap(chunk);
+        }
+        return ThresholdGraph(std::move(offsets), std::move(entries));
+    }
+
+private:
+    struct PendingEdge {
+        uint32_t v1;
+        uint32_t v2;
+        double weight;
+    };
+
+    // Neighbor candidate ranked by match count, then by lower index.
+    // operator< means "better", so a max-heap keeps the worst kept candidate on top.
+    struct Candidate {
+        uint8_t matches;
+        uint32_t index;
+
+        bool operator<(const Candidate& other) const {
+            return matches != other.matches ? matches > other.matches : index < other.index;
+        }
+
+        bool operator==(const Candidate& other) const {
+            return matches == other.matches && index == other.index;
+        }
+    };
+
+    double similarityThreshold_;
+    unsigned numThreads_;
+
+    // Adds the movies' titles as vertices and returns the vertex id of every movie.
+    static vector<uint32_t> addVertices(const vector<pair<int, Movie>>& movies, Graph& graph) {
+        for (const auto& moviePair : movies) {
+            const string title = moviePair.second.getTitle();
+            if (!graph.contains_vertex(title)) {
+                graph.add_vertex(title);
+            }
+        }
+
+        vector<uint32_t> ids(movies.size());
+        for (size_t i = 0; i < movies.size(); ++i) {
+            ids[i] = static_cast<uint32_t>(graph.vertex_id(movies[i].second.getTitle()));
+        }
+        return ids;
+    }
+
+    // Assembles per-block edge buffers into adjacency lists. Per-block degree
+    // counts become per-block write offsets, so every block writes a disjoint
+    // slice of each list in one parallel pass, in block order. Frees the buffers.
+    static vector<vector<pair<size_t, double>>> scatter(vector<vector<PendingEdge>>& buffers,
+                                                       size_t vertexCount, ThreadPool& pool) {
+        const size_t blockCount = buffers.size();
+
+        // Per-block degree contributions of every vertex
+        vector<vector<uint32_t>> offsets(blockCount, vector<uint32_t>(vertexCount, 0));
+        pool.parallel_for(blockCount, [&](size_t block, unsigned) {
+            auto& counts = offsets[block];
+            for (const auto& e : buffers[block]) {
+                ++counts[e.v1];
+                ++counts[e.v2];
+            }
+        });
+
+        // Turn counts into per-block write positions and size every list
+        vector<vector<pair<size_t, double>>> adjacency(vertexCount);
+        const size_t chunkCount = blockCount * 4;
+        pool.parallel_for(chunkCount, [&](size_t chunk, unsigned) {
+            size_t first = vertexCount * chunk / chunkCount;
+            size_t last = vertexCount * (chunk + 1) / chunkCount;
+            for (size_t v = first; v < last; ++v) {
+                uint32_t degree = 0;
+                for (size_t block = 0; block < blockCount; ++block) {
+                    uint32_t count = offsets[block][v];
+                    offsets[block][v] = degree;
+                    degree += count;
+                }
+                adjacency[v].resize(degree);
+            }
+        });
+
+        // Scatter: every block fills its own slots of each list
+        pool.parallel_for(blockCount, [&](size_t block, unsigned) {
+            auto& next = offsets[block];
+            for (const auto& e : buffers[block]) {
+                adjacency[e.v1][next[e.v1]++] = { e.v2, e.weight };
+                adjacency[e.v2][next[e.v2]++] = { e.v1, e.weight };
+            }
+            vector<PendingEdge>().swap(buffers[block]);
+        });
+
+        return adjacency;
+    }
+
+    // Row boundaries splitting the upper triangle of an n x n pair matrix into
+    // `blocks` runs of rows with (nearly) the same number of pairs each.
+    static vector<size_t> triangularBlocks(size_t n, size_t blocks) {
+        vector<size_t> rows(blocks + 1, n);
+        rows[0] = 0;
+        const unsigned long long totalPairs = n < 2 ? 0 : 1ULL * n * (n - 1) / 2;
+        unsigned long long pairsSoFar = 0;
+        size_t block = 1;
+        for (size_t i = 0; i < n && block < blocks; ++i) {
+            pairsSoFar += n - 1 - i;
+            while (block < blocks && pairsSoFar * blocks >= totalPairs * block) {
+                rows[block++] = i + 1;
+            }
+        }
+        return rows;
+    }
+};
+
+#endif
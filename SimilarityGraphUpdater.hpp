@@ -0,0 +1,123 @@
+#ifndef SIMILARITY_GRAPH_UPDATER_HPP
+#define SIMILARITY_GRAPH_UPDATER_HPP
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "Movie.hpp"
+#include "FeatureSignature.hpp"
+#include "WeightedUndirectedGraph.hpp"
+
+// Keeps a similarity graph in step with catalog changes without rebuilding
+// it.
+//
+// Movies are grouped into signature classes (see FeatureSignature.hpp).
+// Every member of a class has the same similarity to a given movie, so a
+// new movie's edges come from the classes similar enough to its own: one
+// signature comparison per class instead of one calculateSimilarity per
+// movie. The edges are then appended to the adjacency lists in place. A
+// removal deletes the vertex and its edges through Graph::remove_vertex.
+// The graph keeps its component labels consistent through both operations.
+//
+// Edges carry the same weights as SimilarityGraphBuilder::build with the same
+// threshold (1 - similarity). A movie added here is appended to its
+// neighbors' lists rather than placed in catalog order, so after updates
+// traversals reach the same vertices as after a rebuild, though possibly in
+// another order.
+class SimilarityGraphUpdater {
+public:
+    explicit SimilarityGraphUpdater(Graph& graph, double similarityThreshold = 0.5)
+        : graph_(graph), similarityThreshold_(similarityThreshold) {}
+
+    // Registers the movies the graph was built from (e.g. the list passed to
+    // SimilarityGraphBuilder::build) so they can be removed and linked to.
+    // The graph has one vertex per title, so a movie whose title is already
+    // indexed (or is not in the graph) is skipped; the vertex stays with the
+    // first movie of that title.
+    void index(const vector<pair<int, Movie>>& movies) {
+        for (const auto& moviePair : movies) {
+            const Movie& movie = moviePair.second;
+            if (movies_.count(movie.getId()) || titles_.count(movie.getTitle()) ||
+                !graph_.contains_vertex(movie.getTitle())) {
+                continue;
+            }
+            remember(movie);
+        }
+    }
+
+    // Adds a movie and its edges to every movie at or above the threshold.
+    // Returns false if its id or title is already in the graph.
+    bool add_movie(const Movie& movie) {
+        const string title = movie.getTitle();
+        if (movies_.count(movie.getId()) || graph_.contains_vertex(title)) return false;
+
+        graph_.add_vertex(title);
+        size_t v = graph_.vertex_id(title);
+        FeatureSignature signature(movie);
+        for (const auto& featureClass : classes_) {
+            double similarity = signatureSimilarity(signature, featureClass.signature);
+            if (similarity < similarityThreshold_) continue;
+            for (const auto& member : featureClass.members) {
+                size_t u = graph_.vertex_id(member.second);
+                if (u != Graph::npos) graph_.add_edge(v, u, 1.0 - similarity);
+            }
+        }
+        remember(movie);
+        return true;
+    }
+
+    // Removes the movie with the given id and its edges. Returns false if
+    // the id is unknown.
+    bool remove_movie(int id) {
+        auto it = movies_.find(id);
+        if (it == movies_.end()) return false;
+
+        auto& members = classes_[it->second].members;
+        auto member = find_if(members.begin(), members.end(),
+                              [id](const pair<int, string>& m) { return m.first == id; });
+        graph_.remove_vertex(member->second);
+        titles_.erase(member->second);
+        members.erase(member);
+        movies_.erase(it);
+        return true;
+    }
+
+    size_t movie_count() const {
+        return movies_.size();
+    }
+
+    size_t class_count() const {
+        return classes_.size();
+    }
+
+private:
+    struct FeatureClass {
+        FeatureSignature signature;
+        vector<pair<int, string>> members;  // (movie id, title)
+    };
+
+    // Files a movie under its signature class.
+    void remember(const Movie& movie) {
+        FeatureSignature signature(movie);
+        auto it = classIndex_.find(signature);
+        if (it == classIndex_.end()) {
+            it = classIndex_.emplace(signature, classes_.size()).first;
+            classes_.push_back({ signature, {} });
+        }
+        classes_[it->second].members.emplace_back(movie.getId(), movie.getTitle());
+        movies_[movie.getId()] = it->second;
+        titles_.insert(movie.getTitle());
+    }
+
+    Graph& graph_;
+    double similarityThreshold_;
+    vector<FeatureClass> classes_;
+    unordered_map<FeatureSignature, size_t, FeatureSignatureHash> classIndex_;
+    unordered_map<int, size_t> movies_;  // movie id -> class
+    unordered_set<string> titles_;       // titles of the indexed movies, one movie each
+};
+
+#endif
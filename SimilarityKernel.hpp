@@ -0,0 +1,178 @@
+#ifndef SIMILARITY_KERNEL_HPP
+#define SIMILARITY_KERNEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Movie.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+// Batched form of calculateSimilarity: one query movie is scored against a
+// run of movies stored column-wise (years as int32, platforms as the 4-bit
+// Movie::getPlatformMask()). For every movie the kernel produces the number
+// of matching features, 0..5:
+//
+//     matches = (year == queryYear) + 4 - popcount(platforms ^ queryPlatforms)
+//
+// and matches / 5.0 is bit-for-bit the value calculateSimilarity returns.
+// AVX2 handles 32 movies per step (8-wide year compares, 32-wide byte xor and
+// popcount), SSE2 and NEON 16; other targets use a branchless scalar loop.
+
+//Writes the number of matching features of the query against `count` movies into out.
+void batchMatchCounts(int32_t queryYear, uint8_t queryPlatforms,
+                      const int32_t* years, const uint8_t* platforms,
+                      size_t count, uint8_t* out) {
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i qYear = _mm256_set1_epi32(queryYear);
+    const __m256i qPlatforms = _mm256_set1_epi8(static_cast<char>(queryPlatforms));
+    const __m256i ones = _mm256_set1_epi8(1);
+    const __m256i fours = _mm256_set1_epi8(4);
+    const __m256i m55 = _mm256_set1_epi8(0x55);
+    const __m256i m03 = _mm256_set1_epi8(0x03);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    for (; i + 32 <= count; i += 32) {
+        __m256i e0 = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(years + i)), qYear);
+        __m256i e1 = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(years + i + 8)), qYear);
+        __m256i e2 = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(years + i + 16)), qYear);
+        __m256i e3 = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(years + i + 24)), qYear);
+        // Packing works per 128-bit lane; the permute restores movie order
+        __m256i eq = _mm256_packs_epi16(_mm256_packs_epi32(e0, e1), _mm256_packs_epi32(e2, e3));
+        eq = _mm256_permutevar8x32_epi32(eq, order);
+
+        __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(platforms + i)), qPlatforms);
+        x = _mm256_sub_epi8(x, _mm256_and_si256(_mm256_srli_epi16(x, 1), m55));
+        x = _mm256_add_epi8(_mm256_and_si256(x, m03), _mm256_and_si256(_mm256_srli_epi16(x, 2), m03));
+
+        __m256i matches = _mm256_sub_epi8(_mm256_add_epi8(_mm256_and_si256(eq, ones), fours), x);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), matches);
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i qYear = _mm_set1_epi32(queryYear);
+    const __m128i qPlatforms = _mm_set1_epi8(static_cast<char>(queryPlatforms));
+    const __m128i ones = _mm_set1_epi8(1);
+    const __m128i fours = _mm_set1_epi8(4);
+    const __m128i m55 = _mm_set1_epi8(0x55);
+    const __m128i m03 = _mm_set1_epi8(0x03);
+    for (; i + 16 <= count; i += 16) {
+        __m128i e0 = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(years + i)), qYear);
+        __m128i e1 = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(years + i + 4)), qYear);
+        __m128i e2 = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(years + i + 8)), qYear);
+        __m128i e3 = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(years + i + 12)), qYear);
+        __m128i eq = _mm_packs_epi16(_mm_packs_epi32(e0, e1), _mm_packs_epi32(e2, e3));
+
+        __m128i x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(platforms + i)), qPlatforms);
+        x = _mm_sub_epi8(x, _mm_and_si128(_mm_srli_epi16(x, 1), m55));
+        x = _mm_add_epi8(_mm_and_si128(x, m03), _mm_and_si128(_mm_srli_epi16(x, 2), m03));
+
+        __m128i matches = _mm_sub_epi8(_mm_add_epi8(_mm_and_si128(eq, ones), fours), x);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), matches);
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const int32x4_t qYear = vdupq_n_s32(queryYear);
+    const uint8x16_t qPlatforms = vdupq_n_u8(queryPlatforms);
+    const uint8x16_t ones = vdupq_n_u8(1);
+    const uint8x16_t fours = vdupq_n_u8(4);
+    for (; i + 16 <= count; i += 16) {
+        uint16x8_t e01 = vcombine_u16(vmovn_u32(vceqq_s32(vld1q_s32(years + i), qYear)),
+                                      vmovn_u32(vceqq_s32(vld1q_s32(years + i + 4), qYear)));
+        uint16x8_t e23 = vcombine_u16(vmovn_u32(vceqq_s32(vld1q_s32(years + i + 8), qYear)),
+                                      vmovn_u32(vceqq_s32(vld1q_s32(years + i + 12), qYear)));
+        uint8x16_t eq = vcombine_u8(vmovn_u16(e01), vmovn_u16(e23));
+
+        uint8x16_t bits = vcntq_u8(veorq_u8(vld1q_u8(platforms + i), qPlatforms));
+        uint8x16_t matches = vsubq_u8(vaddq_u8(vandq_u8(eq, ones), fours), bits);
+        vst1q_u8(out + i, matches);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        unsigned x = (platforms[i] ^ queryPlatforms) & 0xFu;
+        x = x - ((x >> 1) & 0x5u);
+        x = (x & 0x3u) + ((x >> 2) & 0x3u);
+        out[i] = static_cast<uint8_t>((years[i] == queryYear) + 4 - x);
+    }
+}
+
+//Converts a match count from batchMatchCounts into the calculateSimilarity value.
+double similarityFromMatches(uint8_t matches) {
+    return matches / 5.0;
+}
+
+//Class that stores the similarity features of a catalog as packed columns.
+class PackedMovieColumns {
+public:
+
+    PackedMovieColumns() = default;
+
+    //Packs the movies in the given order.
+    explicit PackedMovieColumns(const std::vector<std::pair<int, Movie>>& movies)
+    {
+        years_.reserve(movies.size());
+        platforms_.reserve(movies.size());
+        for (const auto& moviePair : movies)
+            push_back(moviePair.second);
+    }
+
+    //Appends one movie.
+    void push_back(const Movie& movie)
+    {
+        years_.push_back(movie.getYear());
+        platforms_.push_back(static_cast<uint8_t>(movie.getPlatformMask()));
+    }
+
+    //Returns the number of packed movies.
+    size_t size() const
+    {
+        return years_.size();
+    }
+
+    const int32_t* years() const
+    {
+        return years_.data();
+    }
+
+    const uint8_t* platforms() const
+    {
+        return platforms_.data();
+    }
+
+    //Match counts of packed movie `query` against movies [first, first + count).
+    void match_counts(size_t query, size_t first, size_t count, uint8_t* out) const
+    {
+        batchMatchCounts(years_[query], platforms_[query], years_.data() + first, platforms_.data() + first, count, out);
+    }
+
+    //Match counts of any movie against movies [first, first + count).
+    void match_counts(const Movie& query, size_t first, size_t count, uint8_t* out) const
+    {
+        batchMatchCounts(query.getYear(), static_cast<uint8_t>(query.getPlatformMask()),
+                         years_.data() + first, platforms_.data() + first, count, out);
+    }
+
+    //Similarity of the query to every packed movie, equal to calculateSimilarity for each.
+    std::vector<double> similarities(const Movie& query) const
+    {
+        std::vector<uint8_t> matches(size());
+        match_counts(query, 0, size(), matches.data());
+        std::vector<double> result(size());
+        for (size_t i = 0; i < result.size(); ++i)
+            result[i] = similarityFromMatches(matches[i]);
+        return result;
+    }
+
+private:
+
+    std::vector<int32_t> years_;        /**< Release year of every movie. */
+    std::vector<uint8_t> platforms_;    /**< Platform bitmask of every movie. */
+};
+
+#endif
@@ -0,0 +1,81 @@
+#include "Movie.hpp"
+#include "WeightedUndirectedGraph.hpp"
+#include "KeyValueAVLTree.hpp"
+#include "MovieLoader.hpp"
+#include "SimilarityGraphBuilder.hpp"
+#include "CommunityDetection.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// Offline Louvain clustering of the similarity graph, saved as a lookup
+// table of each movie's community and each community's most central
+// movies, then "movies in the same cluster" answered from that table. On
+// the dense threshold graph most movies share a handful of communities, so
+// cluster each movie's 20 most similar movies by default.
+//
+// Usage: Step10 [nearest neighbors, default 20; 0 keeps every pair above the threshold] [threads, default all]
+
+int main(int argc, char* argv[]) {
+    const size_t nearestNeighbors = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20;
+    const unsigned numThreads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 0;
+    const std::string filename = "MoviesOnStreamingPlatforms.csv";
+    const std::string communityFile = "movieCommunities.bin";
+    KeyValueAVLTree<int, Movie> movieTree = loadMoviesToAvlTree(filename);
+    auto movies = movieTree.inorder_traversal();
+
+    Graph movieGraph;
+    SimilarityGraphBuilder builder(0.5);
+    if (nearestNeighbors > 0) {
+        builder.build_nearest_neighbors(movies, movieGraph, nearestNeighbors);
+    } else {
+        builder.build(movies, movieGraph);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<uint32_t> community = louvainCommunities(movieGraph, numThreads);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> clusterTime = end - start;
+
+    CommunityIndex index;
+    index.build(movieGraph, community);
+    std::cout << "Louvain: " << index.community_count() << " communities, modularity "
+              << louvainModularity(louvainLevel(movieGraph), community, index.community_count())
+              << ", " << clusterTime.count() << " seconds" << std::endl;
+
+    CommunityIndex loaded;
+    if (!index.save(communityFile) || !loaded.load(communityFile, movieGraph)) {
+        std::cout << "Could not round-trip " << communityFile << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> queries = { "Roma", "Okja", "The Irishman", "Virunga", "Swades" };
+    const size_t k = 5;
+    for (const auto& title : queries) {
+        size_t v = movieGraph.vertex_id(title);
+        if (v == Graph::npos) continue;
+        uint32_t c = loaded.community_of(v);
+        std::cout << "\n\"" << title << "\" is in community " << c << " (" << loaded.members(c).size()
+                  << " movies); most central:\n";
+        size_t shown = 0;
+        for (uint32_t member : loaded.top_members(c, k + 1)) {
+            if (member == v || shown == k) continue;
+            std::cout << " - " << movieGraph.vertices()[member] << "\n";
+            ++shown;
+        }
+    }
+
+    // Lookup latency over every movie
+    start = std::chrono::high_resolution_clock::now();
+    size_t checksum = 0;
+    for (size_t v = 0; v < loaded.vertex_count(); ++v) {
+        for (uint32_t member : loaded.top_members(loaded.community_of(v), k))
+            checksum += member;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> lookupTime = end - start;
+    std::cout << "\nTop-" << k << " cluster lookup: " << lookupTime.count() / loaded.vertex_count()
+              << " ns per movie (checksum " << checksum << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include "Movie.hpp"
+#include "WeightedUndirectedGraph.hpp"
+#include "KeyValueAVLTree.hpp"
+#include "MovieLoader.hpp"
+#include "SimilarityGraphBuilder.hpp"
+#include "VertexOrdering.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Effect of vertex reordering (degree, BFS and reverse Cuthill-McKee order)
+// on traversal locality: mean id distance across edges, full-BFS time and,
+// where the kernel exposes hardware counters, last-level cache misses. Runs
+// on the movie similarity graph and on a generated grid graph whose ids
+// were shuffled, the case where ordering matters most.
+//
+// Usage: Step11 [grid side, default 1414 (about 2,000,000 vertices)]
+
+//Class that defines a counter of the calling thread's cache misses (Linux perf events).
+class CacheMissCounter {
+public:
+    CacheMissCounter()
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~CacheMissCounter()
+    {
+        if (fd_ >= 0) close(fd_);
+    }
+
+    //Checks if the counter could be opened (it needs hardware counters and perf_event_paranoid <= 2).
+    bool available() const
+    {
+        return fd_ >= 0;
+    }
+
+    void start()
+    {
+        if (fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    //Stops counting and returns the misses since start().
+    unsigned long long stop()
+    {
+        unsigned long long count = 0;
+        if (fd_ < 0) return count;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) count = 0;
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+// Runs full BFS from the given titles and reports locality, time and misses.
+void measure(const std::string& name, const Graph& graph, const std::vector<std::string>& sources,
+             const std::vector<std::vector<std::string>>& reference, CacheMissCounter& counter) {
+    TraversalContext context;
+    std::vector<size_t> order;
+    graph.bfs(graph.vertex_id(sources[0]), context, order);  // warm-up
+
+    double milliseconds = 0.0;
+    unsigned long long misses = 0;
+    bool same = true;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        order.clear();
+        counter.start();
+        auto start = std::chrono::high_resolution_clock::now();
+        graph.bfs(graph.vertex_id(sources[i]), context, order);
+        auto end = std::chrono::high_resolution_clock::now();
+        misses += counter.stop();
+        milliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+        same = same && graph.bfs(sources[i]) == reference[i];
+    }
+
+    std::cout << " - " << std::left << std::setw(10) << name << std::right << " mean edge span "
+              << std::setw(10) << meanEdgeSpan(graph) << ", BFS " << std::setw(8) << milliseconds / sources.size()
+              << " ms";
+    if (counter.available()) std::cout << ", " << misses / sources.size() << " cache misses";
+    std::cout << (same ? "" : " (BFS SEQUENCE CHANGED)") << "\n";
+}
+
+void compareOrderings(const std::string& title, const Graph& graph, const std::vector<std::string>& sources,
+                      CacheMissCounter& counter) {
+    std::vector<std::vector<std::string>> reference;
+    for (const auto& source : sources) {
+        reference.push_back(graph.bfs(source));
+    }
+
+    std::cout << "\n" << title << " (" << graph.vertex_count() << " vertices):\n";
+    measure("original", graph, sources, reference, counter);
+    const std::pair<const char*, std::vector<size_t> (*)(const Graph&)> orderings[] = {
+        { "degree", degreeOrdering<Graph> },
+        { "BFS", breadthFirstOrdering<Graph> },
+        { "RCM", reverseCuthillMcKeeOrdering<Graph> },
+    };
+    for (const auto& ordering : orderings) {
+        Graph reordered = graph;
+        auto start = std::chrono::high_resolution_clock::now();
+        reordered.reorder(ordering.second(reordered));
+        auto end = std::chrono::high_resolution_clock::now();
+        measure(ordering.first, reordered, sources, reference, counter);
+        std::cout << "   (ordered and relabeled in " << std::chrono::duration<double>(end - start).count() << " s)\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const size_t side = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1414;
+    CacheMissCounter counter;
+    if (!counter.available()) {
+        std::cout << "Hardware cache-miss counters are unavailable here; reporting time and edge span only\n";
+    }
+
+    const std::string filename = "MoviesOnStreamingPlatforms.csv";
+    KeyValueAVLTree<int, Movie> movieTree = loadMoviesToAvlTree(filename);
+    auto movies = movieTree.inorder_traversal();
+    Graph movieGraph;
+    SimilarityGraphBuilder builder(0.5);
+    builder.build(movies, movieGraph);
+    compareOrderings("Movie similarity graph", movieGraph, { "Roma", "Okja", "The Irishman" }, counter);
+    movieGraph = Graph();
+
+    // side x side grid, vertex ids shuffled
+    const size_t n = side * side;
+    std::vector<size_t> label(n);
+    std::iota(label.begin(), label.end(), 0);
+    std::shuffle(label.begin(), label.end(), std::mt19937_64(5));
+    Graph grid;
+    for (size_t v = 0; v < n; ++v) {
+        grid.add_vertex("cell" + std::to_string(v));
+    }
+    std::vector<std::vector<std::pair<size_t, double>>> adjacency(n);
+    for (size_t row = 0; row < side; ++row) {
+        for (size_t column = 0; column < side; ++column) {
+            size_t v = label[row * side + column];
+            if (column + 1 < side) {
+                adjacency[v].emplace_back(label[row * side + column + 1], 1.0);
+                adjacency[label[row * side + column + 1]].emplace_back(v, 1.0);
+            }
+            if (row + 1 < side) {
+                adjacency[v].emplace_back(label[(row + 1) * side + column], 1.0);
+                adjacency[label[(row + 1) * side + column]].emplace_back(v, 1.0);
+            }
+        }
+    }
+    grid.set_adjacency(std::move(adjacency));
+    compareOrderings("Shuffled grid graph", grid,
+                     { grid.vertices()[label[0]], grid.vertices()[label[n / 2 + side / 2]] }, counter);
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include "Movie.hpp"
+#include "WeightedUndirectedGraph.hpp"
+#include "KeyValueAVLTree.hpp"
+#include "MovieLoader.hpp"
+#include "SimilarityGraphBuilder.hpp"
+#include "ThresholdGraph.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// Threshold sweep: the similarity graph is built once at the lowest threshold
+// of interest, with every adjacency list sorted by descending similarity, and
+// each higher threshold is then answered by cutting the lists with a binary
+// search instead of rebuilding the graph. Every threshold is checked against
+// a graph rebuilt from scratch at that threshold.
+//
+// Usage: Step12 [lowest threshold, default 0.4]
+
+int main(int argc, char* argv[]) {
+    const double lowestThreshold = argc > 1 ? std::atof(argv[1]) : 0.4;
+    const std::string filename = "MoviesOnStreamingPlatforms.csv";
+    KeyValueAVLTree<int, Movie> movieTree = loadMoviesToAvlTree(filename);
+    auto movies = movieTree.inorder_traversal();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    Graph titles;
+    ThresholdGraph sweep = SimilarityGraphBuilder(lowestThreshold).build_threshold_graph(movies, titles);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Built the sweep graph at " << lowestThreshold << " in "
+              << std::chrono::duration<double>(end - start).count() << " seconds ("
+              << sweep.memory_bytes() / (1024.0 * 1024.0) << " MiB)\n";
+
+    const std::vector<std::string> sources = { "Roma", "Okja", "The Irishman" };
+    TraversalContext context;
+    std::vector<size_t> order, reference;
+    for (double threshold : { 0.4, 0.6, 0.8, 1.0 }) {
+        if (threshold < lowestThreshold) continue;
+
+        // Answer from the sweep graph
+        start = std::chrono::high_resolution_clock::now();
+        size_t components = sweep.component_count(threshold, context);
+        end = std::chrono::high_resolution_clock::now();
+        double componentSeconds = std::chrono::duration<double>(end - start).count();
+        double bfsMilliseconds = 0.0;
+        size_t reached = 0;
+        for (const auto& title : sources) {
+            order.clear();
+            start = std::chrono::high_resolution_clock::now();
+            sweep.bfs(titles.vertex_id(title), threshold, context, order);
+            end = std::chrono::high_resolution_clock::now();
+            bfsMilliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+            reached += order.size();
+        }
+
+        // Rebuild from scratch and compare edges, components and reachable sets
+        start = std::chrono::high_resolution_clock::now();
+        Graph rebuilt;
+        SimilarityGraphBuilder(threshold).build(movies, rebuilt);
+        end = std::chrono::high_resolution_clock::now();
+        double rebuildSeconds = std::chrono::duration<double>(end - start).count();
+        size_t rebuiltEntries = 0;
+        for (size_t v = 0; v < rebuilt.vertex_count(); ++v) {
+            rebuiltEntries += rebuilt.adjacent(v).size();
+        }
+        bool same = rebuiltEntries == sweep.entry_count(threshold) && rebuilt.component_count() == components;
+        for (const auto& title : sources) {
+            size_t source = titles.vertex_id(title);
+            order.clear();
+            reference.clear();
+            sweep.bfs(source, threshold, context, order);
+            rebuilt.bfs(source, context, reference);
+            std::sort(order.begin(), order.end());
+            std::sort(reference.begin(), reference.end());
+            same = same && order == reference;
+        }
+
+        std::cout << "\nThreshold " << threshold << ": " << sweep.entry_count(threshold) / 2 << " edges, "
+                  << components << " components (" << componentSeconds << " s), BFS from "
+                  << sources.size() << " movies reached " << reached << " in " << bfsMilliseconds << " ms\n"
+                  << " - rebuilding instead takes " << rebuildSeconds << " s; same graph: "
+                  << (same ? "yes" : "NO") << "\n";
+    }
+
+    return 0;
+}
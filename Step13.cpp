@@ -0,0 +1,127 @@
+#include "Movie.hpp"
+#include "WeightedUndirectedGraph.hpp"
+#include "KeyValueAVLTree.hpp"
+#include "MovieLoader.hpp"
+#include "SimilarityGraphBuilder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+// "Related movies": the k movies closest to a movie within a few hops, from
+// adjacency lists kept sorted by weight and a best-first search that stops
+// at the k-th result. Latency is
+// measured from every movie, and a sample of queries is checked against an
+// exhaustive hop-by-hop search.
+//
+// Usage: Step13 [k, default 10]
+
+using Clock = std::chrono::high_resolution_clock;
+
+// Checks a top-k answer against shortest distances over at most maxHops edges,
+// found by relaxing every edge once per hop: the distances must be the k
+// smallest (ties at the k-th may pick any of the tied movies), and each
+// listed movie must be at its listed distance.
+bool matchesExhaustiveSearch(const Graph& graph, size_t source, size_t k, size_t maxHops,
+                             const std::vector<std::pair<size_t, double>>& answer) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::vector<double> dist(graph.vertex_count(), infinity);
+    dist[source] = 0.0;
+    for (size_t hop = 0; hop < maxHops; ++hop) {
+        std::vector<double> next = dist;
+        for (size_t v = 0; v < graph.vertex_count(); ++v) {
+            if (dist[v] == infinity) continue;
+            for (const auto& edge : graph.adjacent(v)) {
+                next[edge.first] = std::min(next[edge.first], dist[v] + edge.second);
+            }
+        }
+        dist.swap(next);
+    }
+    std::vector<double> nearest;
+    for (size_t v = 0; v < dist.size(); ++v) {
+        if (v != source && dist[v] != infinity) nearest.push_back(dist[v]);
+    }
+    std::sort(nearest.begin(), nearest.end());
+    if (nearest.size() > k) nearest.resize(k);
+    if (answer.size() != nearest.size()) return false;
+    for (size_t i = 0; i < answer.size(); ++i) {
+        if (answer[i].second != nearest[i] || dist[answer[i].first] != answer[i].second) return false;
+    }
+    return true;
+}
+
+double percentile(std::vector<double> values, double p) {
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(p * (values.size() - 1))];
+}
+
+void benchmarkRelatedMovies(const std::string& name, Graph& graph, size_t k) {
+    std::cout << "\n" << name << ":\n";
+
+    // Before: copy and sort the whole neighbor list for every query
+    std::vector<double> latencies;
+    size_t checksum = 0;
+    for (const auto& title : graph.vertices()) {
+        auto start = Clock::now();
+        auto neighbors = graph.getNeighbors(title);
+        std::sort(neighbors.begin(), neighbors.end(),
+                  [](const std::pair<std::string, double>& a, const std::pair<std::string, double>& b) {
+                      return a.second < b.second;
+                  });
+        if (neighbors.size() > k) neighbors.resize(k);
+        auto end = Clock::now();
+        checksum += neighbors.size();
+        latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    std::cout << " - sorting getNeighbors, 1 hop: p50 " << percentile(latencies, 0.5) << " us, p99 "
+              << percentile(latencies, 0.99) << " us\n";
+
+    auto start = Clock::now();
+    graph.sort_adjacency_by_weight();
+    auto end = Clock::now();
+    std::cout << " - sorted every list by weight in " << std::chrono::duration<double>(end - start).count() << " s\n";
+
+    TraversalContext context;
+    for (size_t hops = 1; hops <= 3; ++hops) {
+        latencies.clear();
+        for (size_t v = 0; v < graph.vertex_count(); ++v) {
+            start = Clock::now();
+            auto related = graph.top_k_within_hops(v, k, hops, context);
+            end = Clock::now();
+            checksum += related.size();
+            latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        }
+        bool same = true;
+        for (size_t v = 0; v < graph.vertex_count(); v += graph.vertex_count() / 40 + 1) {
+            same = same && matchesExhaustiveSearch(graph, v, k, hops, graph.top_k_within_hops(v, k, hops, context));
+        }
+        std::cout << " - top_k_within_hops, " << hops << " hop" << (hops > 1 ? "s" : "") << ": p50 "
+                  << percentile(latencies, 0.5) << " us, p99 " << percentile(latencies, 0.99) << " us, max "
+                  << percentile(latencies, 1.0) << " us; matches exhaustive search: " << (same ? "yes" : "NO") << "\n";
+    }
+    std::cout << " (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+    const size_t k = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10;
+    const std::string filename = "MoviesOnStreamingPlatforms.csv";
+    KeyValueAVLTree<int, Movie> movieTree = loadMoviesToAvlTree(filename);
+    auto movies = movieTree.inorder_traversal();
+    SimilarityGraphBuilder builder(0.5);
+
+    Graph nearestGraph;
+    builder.build_nearest_neighbors(movies, nearestGraph, 20);
+    benchmarkRelatedMovies("20-nearest-neighbor graph", nearestGraph, k);
+
+    Graph thresholdGraph;
+    builder.build(movies, thresholdGraph);
+    benchmarkRelatedMovies("Threshold graph (similarity >= 0.5)", thresholdGraph, k);
+
+    std::cout << "\nRelated to \"Roma\":\n";
+    for (const auto& related : thresholdGraph.top_k_within_hops("Roma", k, 2)) {
+        std::cout << " - " << related.first << " (distance " << related.second << ")\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "Movie.hpp"
+#include "WeightedUndirectedGraph.hpp"
+#include "KeyValueAVLTree.hpp"
+#include "MovieLoader.hpp"
+#include "SimilarityGraphBuilder.hpp"
+#include "PlatformFilters.hpp"
+#include <chrono>
+#include <iostream>
+
+// Platform-filtered recommendations: traversals and path searches take a
+// bitmap of allowed movies, built per streaming service and combined with
+// & and |, and never expand a movie outside it. Each filter is timed against
+// traversing everything and filtering afterwards, and checked against the
+// same traversals on a copy of the graph holding only the allowed movies.
+
+using Clock = std::chrono::high_resolution_clock;
+
+// The subgraph of the allowed movies, vertices and neighbor lists in the same order.
+Graph allowedSubgraph(const Graph& graph, const Bitmap& allowed) {
+    Graph subgraph;
+    allowed.for_each([&](size_t v) { subgraph.add_vertex(graph.vertices()[v]); });
+    std::vector<std::vector<std::pair<size_t, double>>> adjacency(subgraph.vertex_count());
+    allowed.for_each([&](size_t v) {
+        auto& list = adjacency[subgraph.vertex_id(graph.vertices()[v])];
+        for (const auto& edge : graph.adjacent(v)) {
+            if (allowed.test(edge.first)) list.emplace_back(subgraph.vertex_id(graph.vertices()[edge.first]), edge.second);
+        }
+    });
+    subgraph.set_adjacency(std::move(adjacency));
+    return subgraph;
+}
+
+void compareFilter(const std::string& name, const Graph& graph, const Bitmap& allowed) {
+    // A source and a target inside the filter
+    size_t source = Graph::npos, target = Graph::npos;
+    allowed.for_each([&](size_t v) {
+        if (source == Graph::npos) source = v;
+        target = v;
+    });
+    std::cout << "\n" << name << ": " << allowed.count() << " of " << graph.vertex_count() << " movies\n";
+    if (source == Graph::npos) return;
+    const std::string& start = graph.vertices()[source];
+    const std::string& end = graph.vertices()[target];
+
+    TraversalContext context;
+    std::vector<size_t> order;
+    const int runs = 5;
+    auto begin = Clock::now();
+    for (int run = 0; run < runs; ++run) {
+        order.clear();
+        graph.bfs(source, allowed, context, order);
+    }
+    double filtered = std::chrono::duration<double, std::milli>(Clock::now() - begin).count() / runs;
+    size_t reached = order.size();
+
+    size_t kept = 0;
+    begin = Clock::now();
+    for (int run = 0; run < runs; ++run) {
+        order.clear();
+        graph.bfs(source, context, order);
+        kept = 0;
+        for (size_t v : order) {
+            if (allowed.test(v)) ++kept;
+        }
+    }
+    double afterwards = std::chrono::duration<double, std::milli>(Clock::now() - begin).count() / runs;
+
+    Graph subgraph = allowedSubgraph(graph, allowed);
+    std::vector<std::string> path, subgraphPath;
+    bool same = graph.bfs(start, allowed) == subgraph.bfs(start) && graph.dfs(start, allowed) == subgraph.dfs(start);
+    same = same && graph.find_path_bfs(start, end, path, allowed) == subgraph.find_path_bfs(start, end, subgraphPath)
+                && path == subgraphPath;
+    path.clear();
+    subgraphPath.clear();
+    same = same && graph.find_path_dfs(start, end, path, allowed) == subgraph.find_path_dfs(start, end, subgraphPath)
+                && path == subgraphPath;
+
+    std::cout << " - filtered BFS reached " << reached << " movies in " << filtered << " ms; BFS then filter kept "
+              << kept << " in " << afterwards << " ms\n"
+              << " - same as traversing the allowed subgraph: " << (same ? "yes" : "NO") << "\n";
+}
+
+int main() {
+    const std::string filename = "MoviesOnStreamingPlatforms.csv";
+    KeyValueAVLTree<int, Movie> movieTree = loadMoviesToAvlTree(filename);
+    auto movies = movieTree.inorder_traversal();
+    Graph movieGraph;
+    SimilarityGraphBuilder builder(0.5);
+    builder.build(movies, movieGraph);
+
+    auto begin = Clock::now();
+    PlatformFilters platforms(movies, movieGraph);
+    std::cout << "Built the platform bitmaps in "
+              << std::chrono::duration<double, std::micro>(Clock::now() - begin).count() << " us\n";
+
+    compareFilter("Netflix", movieGraph, platforms.service(1));
+    compareFilter("Prime Video", movieGraph, platforms.service(2));
+    compareFilter("Disney+", movieGraph, platforms.service(3));
+    compareFilter("Hulu", movieGraph, platforms.service(4));
+    compareFilter("Netflix or Hulu", movieGraph, platforms.any_of({ 1, 4 }));
+    compareFilter("Netflix and Prime Video", movieGraph, platforms.all_of({ 1, 2 }));
+
+    std::cout << "\nNetflix or Hulu movies reachable from \"Roma\" (first 5):\n";
+    std::vector<std::string> reachable = movieGraph.bfs("Roma", platforms.any_of({ 1, 4 }));
+    for (size_t i = 0; i < reachable.size() && i < 5; ++i) {
+        std::cout << " - " << reachable[i] << "\n";
+    }
+
+    return 0;
+}
@@ -2,10 +2,12 @@
 #include "WeightedUndirectedGraph.hpp"
 #include "KeyValueAVLTree.hpp"
 #include "MovieLoader.hpp"
+#include "SimilarityGraphBuilder.hpp"
+#include "MappedGraph.hpp"
 #include <chrono>
 #include <iostream>
 
-void displayNeighbors(const Graph& graph, const std::string& title) {
+void displayNeighbors(const MappedGraph& graph, const std::string& title) {
     std::cout << "\n=============================\n";
     std::cout << "Neighbors of \"" << title << "\":\n";
     std::cout << "=============================\n";
@@ -14,28 +16,40 @@ void displayNeighbors(const Graph& graph, const std::string& title) {
 
 int main() {
     const std::string filename = "MoviesOnStreamingPlatforms.csv";
-    KeyValueAVLTree<int, Movie> movieTree = loadMoviesToAvlTree(filename);
-    Graph movieGraph;
 
-    // Add nodes to the graph
-    for (const auto& moviePair : movieTree.inorder_traversal()) {
-        const Movie& movie = moviePair.second;
-        movieGraph.add_vertex(movie.getTitle());
-    }
-
-    // Add edges based on similarity
+    // nearestNeighbors = 0 keeps every pair above the threshold; k > 0 keeps
+    // only each movie's k most similar movies (symmetrized)
     double similarityThreshold = 0.5;
-    auto movies = movieTree.inorder_traversal();
-    for (size_t i = 0; i < movies.size(); ++i) {
-        for (size_t j = i + 1; j < movies.size(); ++j) {
-            const Movie& m1 = movies[i].second;
-            const Movie& m2 = movies[j].second;
-            double similarity = calculateSimilarity(m1, m2);
-            if (similarity >= similarityThreshold) {
-                double weight = 1.0 - similarity;
-                movieGraph.add_edge(m1.getTitle(), m2.getTitle(), weight);
-            }
+    size_t nearestNeighbors = 0;
+
+    // The graph is built and saved on the first run; later runs map the saved
+    // file and start right away. Delete the file after changing the catalog.
+    const std::string graphFile = "movieGraph_" + std::to_string(similarityThreshold) + "_"
+                                + std::to_string(nearestNeighbors) + ".bin";
+    MappedGraph movieGraph;
+    auto start = std::chrono::high_resolution_clock::now();
+    if (movieGraph.open(graphFile)) {
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> duration = end - start;
+        std::cout << "Time taken to map the graph: " << duration.count() << " seconds" << std::endl;
+    } else {
+        // Add nodes and similarity edges to the graph, scoring pairs on every core
+        KeyValueAVLTree<int, Movie> movieTree = loadMoviesToAvlTree(filename);
+        auto movies = movieTree.inorder_traversal();
+        Graph builtGraph;
+        SimilarityGraphBuilder builder(similarityThreshold);
+        if (nearestNeighbors > 0) {
+            builder.build_nearest_neighbors(movies, builtGraph, nearestNeighbors);
+        } else {
+            builder.build(movies, builtGraph);
+        }
+        if (!builtGraph.save(graphFile) || !movieGraph.open(graphFile)) {
+            std::cout << "Couldn't save the graph to " << graphFile << std::endl;
+            return 1;
         }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> duration = end - start;
+        std::cout << "Time taken to build the graph: " << duration.count() << " seconds" << std::endl;
     }
 
     std::vector<std::string> movieTitles = {
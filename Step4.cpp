@@ -2,9 +2,16 @@
 #include "WeightedUndirectedGraph.hpp"
 #include "KeyValueAVLTree.hpp"
 #include "MovieLoader.hpp"
+#include "SimilarityGraphBuilder.hpp"
+#include "SimilarityGraphUpdater.hpp"
+#include "CompressedGraph.hpp"
+#include "ImplicitSimilarityGraph.hpp"
+#include "GraphTraversal.hpp"
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <iomanip>
+#include <unordered_set>
 
 void performBFS(const Graph& graph, const std::string& startMovie) {
     std::vector<std::string> bfsResult = graph.bfs(startMovie);
@@ -28,6 +35,120 @@ void performDFS(const Graph& graph, const std::string& startMovie) {
     std::cout << "++++++++++++++++++++++++++++\n";
 }
 
+void benchmarkTraversals(const Graph& graph, const std::vector<std::string>& startMovies) {
+    std::cout << "\n--------------------------------------------\n";
+    std::cout << "Full-component BFS, queue vs direction-optimizing:\n";
+    for (const auto& startMovie : startMovies) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::string> queueResult = graph.bfs(startMovie);
+        auto middle = std::chrono::high_resolution_clock::now();
+        std::vector<std::string> bitmapResult = graph.bfs_direction_optimizing(startMovie);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> queueTime = middle - start;
+        std::chrono::duration<double, std::milli> bitmapTime = end - middle;
+
+        std::sort(queueResult.begin(), queueResult.end());
+        std::sort(bitmapResult.begin(), bitmapResult.end());
+        std::cout << " - \"" << startMovie << "\": " << queueResult.size() << " movies, "
+                  << queueTime.count() << " ms vs " << bitmapTime.count() << " ms"
+                  << (queueResult == bitmapResult ? "" : " (MISMATCH)") << "\n";
+    }
+    std::cout << "--------------------------------------------\n";
+}
+
+void benchmarkLazyTraversals(const Graph& graph, const std::vector<std::string>& startMovies, size_t count) {
+    std::cout << "\n--------------------------------------------\n";
+    std::cout << "First " << count << " BFS movies, full traversal vs lazy traversal:\n";
+    TraversalLimits limits;
+    limits.maxResults = count;
+    for (const auto& startMovie : startMovies) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::string> full = graph.bfs(startMovie);
+        full.resize(std::min(full.size(), count));
+        auto middle = std::chrono::high_resolution_clock::now();
+        std::vector<std::string> lazy;
+        for (size_t v : graph.bfs_lazy(startMovie, limits)) {
+            lazy.push_back(graph.vertices()[v]);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> fullTime = middle - start;
+        std::chrono::duration<double, std::milli> lazyTime = end - middle;
+        std::cout << " - \"" << startMovie << "\": " << fullTime.count() << " ms vs " << lazyTime.count() << " ms"
+                  << (full == lazy ? "" : " (MISMATCH)") << "\n";
+    }
+    std::cout << "--------------------------------------------\n";
+}
+
+void benchmarkCompressedGraph(const Graph& graph, const std::vector<std::string>& startMovies) {
+    auto start = std::chrono::high_resolution_clock::now();
+    CompressedGraph compressed(graph);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> encodeTime = end - start;
+
+    size_t entries = 0;
+    for (size_t v = 0; v < graph.vertex_count(); ++v) {
+        entries += graph.adjacent(v).size();
+    }
+    size_t listBytes = entries * sizeof(std::pair<size_t, double>) + graph.vertex_count() * sizeof(std::vector<int>);
+    std::cout << "\n--------------------------------------------\n";
+    std::cout << "Compressed adjacency (Stream VByte ids, 8-bit weights), encoded in " << encodeTime.count() << " s:\n";
+    std::cout << " - " << listBytes / 1048576.0 << " MiB as adjacency lists, " << entries * 6 / 1048576.0
+              << " MiB as graph file lists, " << compressed.memory_bytes() / 1048576.0 << " MiB compressed\n";
+
+    TraversalContext context;
+    std::vector<size_t> order;
+    for (const auto& startMovie : startMovies) {
+        size_t source = graph.vertex_id(startMovie);
+        order.clear();
+        start = std::chrono::high_resolution_clock::now();
+        graph.bfs(source, context, order);
+        size_t listReached = order.size();
+        auto middle = std::chrono::high_resolution_clock::now();
+        order.clear();
+        compressed.bfs(source, context, order);
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> listTime = middle - start;
+        std::chrono::duration<double, std::milli> compressedTime = end - middle;
+        std::cout << " - BFS from \"" << startMovie << "\": " << listTime.count() << " ms vs "
+                  << compressedTime.count() << " ms" << (listReached == order.size() ? "" : " (MISMATCH)") << "\n";
+    }
+    std::cout << "--------------------------------------------\n";
+}
+
+void benchmarkBatchTraversals(const Graph& graph, size_t batchSize) {
+    std::vector<std::string> starts;
+    for (size_t v = 0; v < graph.vertex_count() && starts.size() < batchSize; v += 7) {
+        starts.push_back(graph.vertices()[v]);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::vector<std::string>> single;
+    for (const auto& startMovie : starts) {
+        single.push_back(graph.bfs_direction_optimizing(startMovie));
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    std::vector<std::vector<std::string>> batch = graph.bfs_batch(starts);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::vector<std::vector<uint32_t>> distances = graph.hop_distances(starts);
+    auto last = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> singleTime = middle - start;
+    std::chrono::duration<double, std::milli> batchTime = end - middle;
+    std::chrono::duration<double, std::milli> distanceTime = last - end;
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < starts.size(); ++i) {
+        std::sort(single[i].begin(), single[i].end());
+        std::sort(batch[i].begin(), batch[i].end());
+        if (single[i] != batch[i]) ++mismatches;
+    }
+    std::cout << "\n--------------------------------------------\n";
+    std::cout << "BFS from " << starts.size() << " movies, one at a time vs multi-source:\n";
+    std::cout << " - " << singleTime.count() << " ms vs " << batchTime.count() << " ms ("
+              << mismatches << " mismatches)\n";
+    std::cout << " - hop distances only: " << distanceTime.count() << " ms\n";
+    std::cout << "--------------------------------------------\n";
+}
+
 void verifyPaths(const Graph& graph, const std::vector<std::pair<std::string, std::string>>& moviePairs) {
     for (const auto& pair : moviePairs) {
         const std::string& movie1 = pair.first;
@@ -38,6 +159,12 @@ void verifyPaths(const Graph& graph, const std::vector<std::pair<std::string, st
         std::cout << "Verifying path between \"" << movie1 << "\" and \"" << movie2 << "\":\n";
         std::cout << "=============================\n";
 
+        if (!graph.same_component(movie1, movie2)) {
+            std::cout << "No path: the movies are in different components.\n";
+            std::cout << "=============================\n";
+            continue;
+        }
+
         if (graph.find_path_bfs(movie1, movie2, path)) {
             std::cout << "Path found with BFS:\n";
             for (const auto& movie : path) {
@@ -63,35 +190,244 @@ void verifyPaths(const Graph& graph, const std::vector<std::pair<std::string, st
             std::cout << "No path found with DFS.\n";
         }
 
+        path.clear();
+        double distance = 0.0;
+        if (graph.shortest_path(movie1, movie2, path, distance)) {
+            std::cout << "Shortest path:\n";
+            for (const auto& movie : path) {
+                std::cout << movie << " -> ";
+            }
+            std::cout << "end\n";
+            std::cout << "Distance: " << distance << "\n";
+        } else {
+            std::cout << "No shortest path found.\n";
+        }
+
         std::cout << "=============================\n";
     }
 }
 
+void benchmarkPathQueries(const Graph& graph, size_t queryCount) {
+    std::vector<std::pair<size_t, size_t>> queries;
+    const size_t n = graph.vertex_count();
+    for (size_t i = 0; i < n && queries.size() < queryCount; ++i) {
+        size_t a = (i * 7919) % n, b = (i * 104729 + 1) % n;
+        if (graph.same_component(a, b)) queries.emplace_back(a, b);
+    }
+
+    // Title-keyed hash maps built per query, as every traversal used to do
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t hashedHops = 0;
+    for (const auto& query : queries) {
+        std::vector<std::string> path;
+        findPathBreadthFirst(graph, graph.vertices()[query.first], graph.vertices()[query.second], path);
+        hashedHops += path.size();
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    TraversalContext context;
+    std::vector<size_t> path;
+    size_t contextHops = 0;
+    for (const auto& query : queries) {
+        path.clear();
+        graph.find_path_bfs(query.first, query.second, context, path);
+        contextHops += path.size();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::micro> hashedTime = middle - start;
+    std::chrono::duration<double, std::micro> contextTime = end - middle;
+
+    std::cout << "\n--------------------------------------------\n";
+    std::cout << "BFS path queries (" << queries.size() << "), per-query hash maps vs reused traversal context:\n";
+    std::cout << " - " << hashedTime.count() / queries.size() << " us vs "
+              << contextTime.count() / queries.size() << " us per query"
+              << (hashedHops == contextHops ? "" : " (MISMATCH)") << "\n";
+    std::cout << "--------------------------------------------\n";
+}
+
+void benchmarkShortestPaths(const Graph& graph, const std::vector<std::pair<std::string, std::string>>& moviePairs) {
+    const int repetitions = 100;
+    std::cout << "\n--------------------------------------------\n";
+    std::cout << "Shortest path latency (average of " << repetitions << " queries):\n";
+    for (const auto& pair : moviePairs) {
+        std::vector<std::string> path;
+        double distance = 0.0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < repetitions; ++i) {
+            graph.shortest_path(pair.first, pair.second, path, distance);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::micro> duration = end - start;
+        std::cout << " - \"" << pair.first << "\" -> \"" << pair.second << "\": "
+                  << duration.count() / repetitions << " us\n";
+    }
+    std::cout << "--------------------------------------------\n";
+}
+
+void benchmarkLandmarks(const Graph& graph, const std::vector<std::pair<std::string, std::string>>& moviePairs) {
+    const std::string landmarkFile = "movieLandmarks.bin";
+    LandmarkOracle landmarks;
+    auto start = std::chrono::high_resolution_clock::now();
+    landmarks.build(graph, 16);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> buildTime = end - start;
+
+    // Round-trip the tables through disk as a serving process would load them
+    LandmarkOracle loaded;
+    if (!landmarks.save(landmarkFile) || !loaded.load(landmarkFile, graph)) {
+        std::cout << "Could not save and reload the landmark tables." << std::endl;
+        return;
+    }
+
+    std::cout << "\n--------------------------------------------\n";
+    std::cout << "Landmark oracle: " << loaded.landmark_count() << " landmarks, built in "
+              << buildTime.count() << " seconds\n";
+    const int repetitions = 100;
+    for (const auto& pair : moviePairs) {
+        size_t u = graph.vertex_id(pair.first);
+        size_t v = graph.vertex_id(pair.second);
+        if (u == Graph::npos || v == Graph::npos) continue;
+
+        std::vector<std::string> path;
+        double distance = 0.0, lower = 0.0, upper = 0.0;
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < repetitions; ++i) {
+            lower = loaded.lower_bound(u, v);
+            upper = loaded.upper_bound(u, v);
+        }
+        auto middle = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < repetitions; ++i) {
+            graph.shortest_path(pair.first, pair.second, path, distance, loaded);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::micro> boundTime = middle - start;
+        std::chrono::duration<double, std::micro> searchTime = end - middle;
+
+        std::cout << " - \"" << pair.first << "\" -> \"" << pair.second << "\": "
+                  << lower << " <= " << distance << " <= " << upper << ", bounds "
+                  << boundTime.count() / repetitions << " us, A* " << searchTime.count() / repetitions << " us\n";
+    }
+    std::cout << "--------------------------------------------\n";
+}
+
+// Builds the stored-edge graph and the implicit graph (no stored edges) from
+// the same movies, one per title, and checks that the traversals of
+// GraphTraversal.hpp return the same results on both.
+void compareImplicitGraph(const std::vector<std::pair<int, Movie>>& movies, double similarityThreshold,
+                          const std::vector<std::string>& startMovies,
+                          const std::vector<std::pair<std::string, std::string>>& moviePairs) {
+    std::vector<std::pair<int, Movie>> distinct;
+    std::unordered_set<std::string> titles;
+    for (const auto& moviePair : movies) {
+        if (titles.insert(moviePair.second.getTitle()).second) distinct.push_back(moviePair);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    Graph stored;
+    SimilarityGraphBuilder(similarityThreshold).build(distinct, stored);
+    auto middle = std::chrono::high_resolution_clock::now();
+    ImplicitSimilarityGraph implicit(similarityThreshold);
+    for (const auto& moviePair : distinct) {
+        implicit.add_movie(moviePair.second);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> storedBuild = middle - start;
+    std::chrono::duration<double> implicitBuild = end - middle;
+
+    size_t entries = 0;
+    for (size_t v = 0; v < stored.vertex_count(); ++v) {
+        entries += stored.adjacent(v).size();
+    }
+    size_t listBytes = entries * sizeof(std::pair<size_t, double>) + stored.vertex_count() * sizeof(std::vector<int>);
+
+    std::cout << "\n--------------------------------------------\n";
+    std::cout << "Stored-edge graph vs implicit graph (" << distinct.size() << " movies, "
+              << implicit.class_count() << " signature classes):\n";
+    std::cout << " - built in " << storedBuild.count() << " s vs " << implicitBuild.count() << " s; "
+              << listBytes / 1048576.0 << " MiB of adjacency lists vs " << implicit.memory_bytes() / 1048576.0
+              << " MiB of classes\n";
+
+    std::chrono::duration<double, std::milli> storedTime(0), implicitTime(0);
+    bool same = true;
+    for (const auto& title : startMovies) {
+        start = std::chrono::high_resolution_clock::now();
+        auto storedBfs = breadthFirstSearch(stored, title);
+        auto storedDfs = depthFirstSearch(stored, title);
+        middle = std::chrono::high_resolution_clock::now();
+        auto implicitBfs = breadthFirstSearch(implicit, title);
+        auto implicitDfs = depthFirstSearch(implicit, title);
+        end = std::chrono::high_resolution_clock::now();
+        storedTime += middle - start;
+        implicitTime += end - middle;
+        same = same && storedBfs == implicitBfs && storedDfs == implicitDfs;
+    }
+    std::cout << " - BFS and DFS from " << startMovies.size() << " movies: " << storedTime.count() << " ms vs "
+              << implicitTime.count() << " ms\n";
+
+    storedTime = implicitTime = std::chrono::duration<double, std::milli>(0);
+    for (const auto& pair : moviePairs) {
+        std::vector<std::string> storedPath, implicitPath;
+        start = std::chrono::high_resolution_clock::now();
+        bool storedFound = findPathBreadthFirst(stored, pair.first, pair.second, storedPath);
+        double storedDistance = calculatePathDistance(stored, storedPath);
+        middle = std::chrono::high_resolution_clock::now();
+        bool implicitFound = findPathBreadthFirst(implicit, pair.first, pair.second, implicitPath);
+        double implicitDistance = calculatePathDistance(implicit, implicitPath);
+        end = std::chrono::high_resolution_clock::now();
+        storedTime += middle - start;
+        implicitTime += end - middle;
+        same = same && storedFound == implicitFound && storedPath == implicitPath && storedDistance == implicitDistance;
+    }
+    std::cout << " - BFS paths and distances for " << moviePairs.size() << " pairs: " << storedTime.count()
+              << " ms vs " << implicitTime.count() << " ms\n";
+    std::cout << " - same results: " << (same ? "yes" : "NO") << "\n";
+    std::cout << "--------------------------------------------\n";
+}
+
+void updateCatalog(Graph& graph, const std::vector<std::pair<int, Movie>>& movies, double similarityThreshold) {
+    SimilarityGraphUpdater updater(graph, similarityThreshold);
+    updater.index(movies);
+
+    std::cout << "\n--------------------------------------------\n";
+    std::cout << "Catalog updates without a rebuild:\n";
+    for (size_t i = 0; i < movies.size(); i += movies.size() / 4) {
+        const Movie& movie = movies[i].second;
+        auto start = std::chrono::high_resolution_clock::now();
+        updater.remove_movie(movies[i].first);
+        auto middle = std::chrono::high_resolution_clock::now();
+        updater.add_movie(movie);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> removeTime = middle - start;
+        std::chrono::duration<double, std::milli> addTime = end - middle;
+        std::cout << " - \"" << movie.getTitle() << "\": removed in " << removeTime.count()
+                  << " ms, added back in " << addTime.count() << " ms, "
+                  << graph.getNeighbors(movie.getTitle()).size() << " neighbors\n";
+    }
+    std::cout << "Connected components: " << graph.component_count() << "\n";
+    std::cout << "--------------------------------------------\n";
+}
+
 int main() {
     const std::string filename = "MoviesOnStreamingPlatforms.csv";
     KeyValueAVLTree<int, Movie> movieTree = loadMoviesToAvlTree(filename);
     Graph movieGraph;
 
-    // Add nodes to the graph
-    for (const auto& moviePair : movieTree.inorder_traversal()) {
-        const Movie& movie = moviePair.second;
-        movieGraph.add_vertex(movie.getTitle());
-    }
-
-    // Add edges based on similarity
+    // Add nodes and similarity edges to the graph, scoring pairs on every core
+    // nearestNeighbors = 0 keeps every pair above the threshold; k > 0 keeps
+    // only each movie's k most similar movies (symmetrized)
     double similarityThreshold = 0.5;
+    size_t nearestNeighbors = 0;
     auto movies = movieTree.inorder_traversal();
-    for (size_t i = 0; i < movies.size(); ++i) {
-        for (size_t j = i + 1; j < movies.size(); ++j) {
-            const Movie& m1 = movies[i].second;
-            const Movie& m2 = movies[j].second;
-            double similarity = calculateSimilarity(m1, m2);
-            if (similarity >= similarityThreshold) {
-                double weight = 1.0 - similarity;
-                movieGraph.add_edge(m1.getTitle(), m2.getTitle(), weight);
-            }
-        }
+    auto start = std::chrono::high_resolution_clock::now();
+    SimilarityGraphBuilder builder(similarityThreshold);
+    if (nearestNeighbors > 0) {
+        builder.build_nearest_neighbors(movies, movieGraph, nearestNeighbors);
+    } else {
+        builder.build(movies, movieGraph);
     }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end - start;
+    std::cout << "Time taken to build the graph: " << duration.count() << " seconds" << std::endl;
+    std::cout << "Connected components: " << movieGraph.component_count() << std::endl;
 
     // Perform BFS and DFS from a product and display results
     std::vector<std::string> startMovies = {
@@ -103,6 +439,11 @@ int main() {
         performDFS(movieGraph, startMovie);
     }
 
+    benchmarkTraversals(movieGraph, startMovies);
+    benchmarkLazyTraversals(movieGraph, startMovies, 10);
+    benchmarkCompressedGraph(movieGraph, startMovies);
+    benchmarkBatchTraversals(movieGraph, 1024);
+
     // Verify paths between pairs of movies and display the distances
     std::vector<std::pair<std::string, std::string>> moviePairs = {
         {"Roma", "Okja"},
@@ -113,6 +454,16 @@ int main() {
     };
 
     verifyPaths(movieGraph, moviePairs);
+    benchmarkPathQueries(movieGraph, 20);
+    benchmarkShortestPaths(movieGraph, moviePairs);
+    benchmarkLandmarks(movieGraph, moviePairs);
+    // Two traversal starts only: the title-keyed traversals of GraphTraversal.hpp
+    // take several seconds each over the whole dense component
+    compareImplicitGraph(movies, similarityThreshold, { "Roma", "Virunga" }, moviePairs);
+
+    // Remove and re-add a few movies in place (this reorders adjacency lists,
+    // so it runs after every traversal above)
+    updateCatalog(movieGraph, movies, similarityThreshold);
 
     return 0;
 }
@@ -0,0 +1,78 @@
+#include "Movie.hpp"
+#include "WeightedUndirectedGraph.hpp"
+#include "KeyValueAVLTree.hpp"
+#include "MovieLoader.hpp"
+#include "SimilarityKernel.hpp"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+// Compares the batch similarity kernel with calculateSimilarity: first checks
+// that both give bit-identical values for every pair of the catalog, then
+// times one-vs-all scoring with each.
+
+int main() {
+    const std::string filename = "MoviesOnStreamingPlatforms.csv";
+    KeyValueAVLTree<int, Movie> movieTree = loadMoviesToAvlTree(filename);
+    auto movies = movieTree.inorder_traversal();
+    PackedMovieColumns columns(movies);
+    const size_t n = movies.size();
+
+    // Equivalence: every pair, with runs of every length so each vector tail is exercised
+    size_t mismatches = 0;
+    std::vector<uint8_t> matches(n);
+    for (size_t i = 0; i < n; ++i) {
+        size_t count = n - i - 1;
+        columns.match_counts(i, i + 1, count, matches.data());
+        for (size_t k = 0; k < count; ++k) {
+            double scalar = calculateSimilarity(movies[i].second, movies[i + 1 + k].second);
+            double batch = similarityFromMatches(matches[k]);
+            if (std::memcmp(&scalar, &batch, sizeof(double)) != 0) {
+                if (mismatches < 10) {
+                    std::cout << "Mismatch between \"" << movies[i].second.getTitle() << "\" and \""
+                              << movies[i + 1 + k].second.getTitle() << "\": " << scalar << " vs " << batch << "\n";
+                }
+                ++mismatches;
+            }
+        }
+    }
+    std::cout << "Checked " << n * (n - 1) / 2 << " pairs, " << mismatches << " mismatches" << std::endl;
+
+    // Microbenchmark: score every movie against the whole catalog
+    const int rounds = 5;
+    double checksum = 0.0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                checksum += calculateSimilarity(movies[i].second, movies[j].second);
+            }
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> scalarTime = end - start;
+
+    unsigned long long matchSum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < n; ++i) {
+            columns.match_counts(i, 0, n, matches.data());
+            matchSum += matches[i];
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> batchTime = end - start;
+
+    double pairs = static_cast<double>(rounds) * n * n;
+    std::cout << "--------------------------------------------" << std::endl;
+    std::cout << "Scalar calculateSimilarity: " << scalarTime.count() << " seconds ("
+              << scalarTime.count() / pairs * 1e9 << " ns/pair)" << std::endl;
+    std::cout << "Batch kernel:               " << batchTime.count() << " seconds ("
+              << batchTime.count() / pairs * 1e9 << " ns/pair)" << std::endl;
+    std::cout << "Speedup: " << scalarTime.count() / batchTime.count() << "x" << std::endl;
+    std::cout << "Checksums: " << checksum << " / " << matchSum << std::endl;
+    std::cout << "--------------------------------------------" << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include "Movie.hpp"
+#include "KeyValueAVLTree.hpp"
+#include "MovieLoader.hpp"
+#include "HnswIndex.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// "More like this" with the HNSW index: a few queries on the real catalog,
+// then recall and latency against brute force on a synthetic catalog.
+//
+// Usage: Step6 [synthetic catalog size, default 1000000] [threads, default all]
+
+// Generates a movie with catalog-like feature distributions
+Movie syntheticMovie(int id, std::mt19937& rng) {
+    static const char* ages[] = { "all", "7+", "13+", "16+", "18+", "" };
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    int year = 1901 + static_cast<int>(120 * std::pow(uniform(rng), 0.25));
+    std::string rottenTomatoes = std::to_string(10 + static_cast<int>(rng() % 91)) + "/100";
+    return Movie(id, "Synthetic " + std::to_string(id), year, ages[rng() % 6], rottenTomatoes,
+                 uniform(rng) < 0.35, uniform(rng) < 0.15, uniform(rng) < 0.55, uniform(rng) < 0.05,
+                 uniform(rng) < 0.1 ? 1 : 0);
+}
+
+int main(int argc, char* argv[]) {
+    const size_t catalogSize = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const unsigned numThreads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 0;
+    const size_t k = 10;
+
+    // Real catalog
+    const std::string filename = "MoviesOnStreamingPlatforms.csv";
+    KeyValueAVLTree<int, Movie> movieTree = loadMoviesToAvlTree(filename);
+    auto movies = movieTree.inorder_traversal();
+    HnswIndex catalogIndex;
+    catalogIndex.build(movies, numThreads);
+
+    std::vector<int> queryIds = { 4, 5, 1, 9, 14 };
+    for (int id : queryIds) {
+        KeyValueAVLNode<int, Movie>* node = movieTree.find(id);
+        if (!node) continue;
+        std::cout << "\n=============================\n";
+        std::cout << "More like \"" << node->value.getTitle() << "\":\n";
+        std::cout << "=============================\n";
+        for (const auto& result : catalogIndex.search(id, k)) {
+            std::cout << " - " << movieTree.find(result.first)->value.getTitle()
+                      << " (distance: " << result.second << ")\n";
+        }
+    }
+
+    // Synthetic catalog
+    std::mt19937 rng(7);
+    std::vector<int> ids(catalogSize);
+    std::vector<float> features(catalogSize * kMovieFeatureCount);
+    for (size_t i = 0; i < catalogSize; ++i) {
+        ids[i] = static_cast<int>(i);
+        movieFeatures(syntheticMovie(static_cast<int>(i), rng), features.data() + i * kMovieFeatureCount);
+    }
+
+    HnswIndex index(16, 200);
+    auto start = std::chrono::high_resolution_clock::now();
+    index.build(ids, std::move(features), kMovieFeatureCount, numThreads);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> buildTime = end - start;
+    std::cout << "\n--------------------------------------------" << std::endl;
+    std::cout << "Synthetic catalog: " << catalogSize << " movies" << std::endl;
+    std::cout << "Time taken to build the HNSW index: " << buildTime.count() << " seconds" << std::endl;
+
+    const size_t queryCount = 200;
+    std::vector<int> queries(queryCount);
+    for (auto& q : queries) q = static_cast<int>(rng() % catalogSize);
+
+    std::vector<std::vector<std::pair<int, float>>> exact(queryCount);
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t q = 0; q < queryCount; ++q) {
+        exact[q] = index.search_exact(queries[q], k);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> exactTime = end - start;
+    std::cout << "Brute force: " << exactTime.count() / queryCount * 1e3 << " ms/query" << std::endl;
+    std::cout << "--------------------------------------------" << std::endl;
+    std::cout << std::setw(6) << "ef" << std::setw(14) << "ms/query" << std::setw(12) << "recall@" << k
+              << std::setw(12) << "speedup" << std::endl;
+
+    for (size_t ef : { 10, 20, 40, 80, 160, 320 }) {
+        index.set_ef(ef);
+        std::vector<std::vector<std::pair<int, float>>> approx(queryCount);
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t q = 0; q < queryCount; ++q) {
+            approx[q] = index.search(queries[q], k);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> approxTime = end - start;
+
+        // Many synthetic movies share a feature vector, so any result at most
+        // as far as the true k-th neighbor counts as a hit
+        size_t hits = 0, total = 0;
+        for (size_t q = 0; q < queryCount; ++q) {
+            if (exact[q].empty()) continue;
+            float kth = exact[q].back().second;
+            for (const auto& r : approx[q]) {
+                if (r.second <= kth + 1e-6f) ++hits;
+            }
+            total += exact[q].size();
+        }
+
+        std::cout << std::setw(6) << ef
+                  << std::setw(14) << approxTime.count() / queryCount * 1e3
+                  << std::setw(13) << (total ? static_cast<double>(hits) / total : 0.0)
+                  << std::setw(11) << exactTime.count() / approxTime.count() << "x" << std::endl;
+    }
+    std::cout << "--------------------------------------------" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "WeightedUndirectedGraph.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// Thread scaling of the parallel BFS and connected components on a
+// generated graph: uniformly random edges between `vertices` vertices,
+// 10,000,000 edges by default.
+//
+// Usage: Step8 [vertices, default 1000000] [edges, default 10000000] [max threads, default all]
+
+int main(int argc, char* argv[]) {
+    const size_t vertexCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const size_t edgeCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+    const unsigned maxThreads = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : ThreadPool::defaultThreadCount();
+
+    Graph graph;
+    for (size_t v = 0; v < vertexCount; ++v) {
+        graph.add_vertex("v" + std::to_string(v));
+    }
+    std::vector<std::vector<std::pair<size_t, double>>> adjacency(vertexCount);
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> weight(0.0, 1.0);
+    for (size_t e = 0; e < edgeCount;) {
+        size_t v1 = rng() % vertexCount;
+        size_t v2 = rng() % vertexCount;
+        if (v1 == v2) continue;
+        double w = weight(rng);
+        adjacency[v1].emplace_back(v2, w);
+        adjacency[v2].emplace_back(v1, w);
+        ++e;
+    }
+    graph.set_adjacency(std::move(adjacency));
+    std::cout << "Generated graph: " << vertexCount << " vertices, " << edgeCount << " edges" << std::endl;
+
+    // Sequential references
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<size_t> reference = directionOptimizingBfs(graph, 0);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> referenceTime = end - start;
+    std::cout << "Direction-optimizing BFS (1 thread): " << referenceTime.count() << " seconds, "
+              << reference.size() << " vertices reached" << std::endl;
+
+    std::cout << "--------------------------------------------" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "BFS (s)" << std::setw(12) << "CC (s)"
+              << std::setw(14) << "components" << std::endl;
+
+    double bfsBase = 0.0, ccBase = 0.0;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+
+        start = std::chrono::high_resolution_clock::now();
+        std::vector<size_t> order = parallelBfs(graph, 0, pool);
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> bfsTime = end - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        std::vector<size_t> label = parallelConnectedComponents(graph, pool);
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> ccTime = end - start;
+
+        // The BFS must reach exactly the vertices of the source's component
+        size_t components = 0, sourceComponent = 0;
+        for (size_t v = 0; v < label.size(); ++v) {
+            if (label[v] == v) ++components;
+            if (label[v] == label[0]) ++sourceComponent;
+        }
+        bool consistent = order.size() == reference.size() && order.size() == sourceComponent;
+
+        if (threads == 1) {
+            bfsBase = bfsTime.count();
+            ccBase = ccTime.count();
+        }
+        std::cout << std::setw(8) << threads
+                  << std::setw(12) << bfsTime.count() << std::setw(12) << ccTime.count()
+                  << std::setw(14) << components
+                  << "   speedup " << bfsBase / bfsTime.count() << "x / " << ccBase / ccTime.count() << "x"
+                  << (consistent ? "" : "   (MISMATCH)") << std::endl;
+    }
+    std::cout << "--------------------------------------------" << std::endl;
+
+    return 0;
+}
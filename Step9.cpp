@@ -0,0 +1,87 @@
+#include "Movie.hpp"
+#include "WeightedUndirectedGraph.hpp"
+#include "KeyValueAVLTree.hpp"
+#include "MovieLoader.hpp"
+#include "SimilarityGraphBuilder.hpp"
+#include "PersonalizedPageRank.hpp"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+// Personalized PageRank recommendations on the similarity graph: top movies
+// for single seeds and a seed set with forward push, then forward push
+// against Monte-Carlo walks for latency and agreement.
+
+void printRecommendations(const Graph& graph, const std::vector<std::pair<size_t, double>>& ranked) {
+    for (size_t i = 0; i < ranked.size(); ++i) {
+        std::cout << std::setw(2) << i + 1 << ". " << graph.vertices()[ranked[i].first]
+                  << " (score: " << ranked[i].second << ")\n";
+    }
+}
+
+int main() {
+    const std::string filename = "MoviesOnStreamingPlatforms.csv";
+    KeyValueAVLTree<int, Movie> movieTree = loadMoviesToAvlTree(filename);
+    auto movies = movieTree.inorder_traversal();
+    // Walks spread evenly over the dense threshold graph, where a movie's
+    // neighbors number in the thousands, so recommend over each movie's 20
+    // most similar movies instead
+    Graph movieGraph;
+    SimilarityGraphBuilder builder(0.5);
+    builder.build_nearest_neighbors(movies, movieGraph, 20);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    PersonalizedPageRank pageRank(movieGraph);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> setupTime = end - start;
+    std::cout << "Time taken to build the alias tables: " << setupTime.count() << " seconds" << std::endl;
+
+    const size_t k = 10;
+    // Forward push bounds the error of a score by tolerance * degree; the
+    // walks get an absolute tolerance
+    const double pushTolerance = 1e-6;
+    const double walkTolerance = 1e-3;
+    std::vector<std::vector<std::string>> queries = {
+        { "Roma" }, { "Okja" }, { "The Irishman" }, { "Dangal", "Lagaan: Once Upon a Time in India", "Swades" }
+    };
+
+    for (const auto& query : queries) {
+        std::vector<size_t> seeds;
+        std::cout << "\n=============================\n";
+        std::cout << "Recommended for";
+        for (const auto& title : query) {
+            std::cout << " \"" << title << "\"";
+            seeds.push_back(movieGraph.vertex_id(title));
+        }
+        std::cout << ":\n=============================\n";
+
+        start = std::chrono::high_resolution_clock::now();
+        auto pushed = pageRank.forward_push(seeds, k, pushTolerance);
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> pushTime = end - start;
+        printRecommendations(movieGraph, pushed);
+
+        start = std::chrono::high_resolution_clock::now();
+        auto sampled = pageRank.monte_carlo(seeds, k, walksForTolerance(walkTolerance));
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> walkTime = end - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        auto budgeted = pageRank.monte_carlo(seeds, k, walksForTolerance(walkTolerance), 0.15, 0, 0.005);
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> budgetTime = end - start;
+
+        // Many movies tie on score, so compare the two rankings rank by rank
+        double gap = 0.0;
+        for (size_t i = 0; i < std::min(pushed.size(), sampled.size()); ++i) {
+            gap = std::max(gap, std::abs(pushed[i].second - sampled[i].second));
+        }
+        std::cout << "Forward push: " << pushTime.count() << " ms; Monte Carlo ("
+                  << walksForTolerance(walkTolerance) << " walks): " << walkTime.count()
+                  << " ms, largest score gap at equal rank " << gap << "; 5 ms budget: "
+                  << budgetTime.count() << " ms, " << budgeted.size() << " results\n";
+    }
+
+    return 0;
+}
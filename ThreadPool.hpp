@@ -0,0 +1,128 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Class that defines a fixed-size pool of worker threads for data-parallel loops.
+class ThreadPool {
+public:
+
+    //Creates a pool with the given number of threads (0 uses every hardware thread).
+    //The calling thread takes part in the work, so numThreads - 1 workers are spawned.
+    explicit ThreadPool(unsigned numThreads = 0)
+    {
+        if (numThreads == 0)
+            numThreads = defaultThreadCount();
+
+        for (unsigned i = 1; i < numThreads; ++i)
+            workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    //Stops and joins the workers.
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    //Returns the number of threads that run tasks, including the caller.
+    unsigned size() const
+    {
+        return static_cast<unsigned>(workers_.size()) + 1;
+    }
+
+    //Returns the number of hardware threads, or 1 when it cannot be determined.
+    static unsigned defaultThreadCount()
+    {
+        unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+
+    //Runs fn(task, thread) for every task in [0, taskCount) and blocks until all are done.
+    //Tasks are claimed dynamically; `thread` is in [0, size()) and is stable for the call,
+    //so it can index per-thread scratch buffers.
+    void parallel_for(size_t taskCount, const std::function<void(size_t, unsigned)>& fn)
+    {
+        if (taskCount == 0)
+            return;
+
+        if (workers_.empty()) {
+            for (size_t task = 0; task < taskCount; ++task)
+                fn(task, 0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &fn;
+            taskCount_ = taskCount;
+            nextTask_.store(0);
+            active_ = static_cast<unsigned>(workers_.size());
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        runTasks(0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return active_ == 0; });
+        job_ = nullptr;
+    }
+
+private:
+
+    //Claims and runs tasks of the current job until none are left.
+    void runTasks(unsigned thread)
+    {
+        for (size_t task = nextTask_.fetch_add(1); task < taskCount_; task = nextTask_.fetch_add(1))
+            (*job_)(task, thread);
+    }
+
+    //Body of every worker thread: waits for a new job, helps run it, reports completion.
+    void workerLoop(unsigned thread)
+    {
+        unsigned long long seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+                if (stopping_)
+                    return;
+                seen = generation_;
+            }
+
+            runTasks(thread);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_ == 0)
+                done_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers_;                              /**< Spawned worker threads. */
+    std::mutex mutex_;                                              /**< Guards the job state below. */
+    std::condition_variable wake_;                                  /**< Signals a new job or shutdown. */
+    std::condition_variable done_;                                  /**< Signals that every worker finished the job. */
+    const std::function<void(size_t, unsigned)>* job_ = nullptr;    /**< The running job. */
+    size_t taskCount_ = 0;                                          /**< Number of tasks in the running job. */
+    std::atomic<size_t> nextTask_{ 0 };                             /**< Next unclaimed task. */
+    unsigned active_ = 0;                                           /**< Workers still running the job. */
+    unsigned long long generation_ = 0;                             /**< Incremented for every job. */
+    bool stopping_ = false;                                         /**< Set when the pool is destroyed. */
+};
+
+#endif
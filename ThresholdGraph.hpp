@@ -0,0 +1,181 @@
+#ifndef THRESHOLD_GRAPH_HPP
+#define THRESHOLD_GRAPH_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "TraversalContext.hpp"
+
+//Class that defines a similarity graph that answers queries at any threshold without a rebuild.
+//
+//It is built once at the lowest threshold of interest and stores every vertex's neighbors in
+//one array (CSR layout), each list sorted by descending similarity (ties by ascending id). The
+//neighbors at or above a threshold are then a prefix of the list, found by binary search, and
+//traversals at that threshold only ever see those prefixes. Similarities are stored in single
+//precision and thresholds are compared in single precision too, so a stored similarity always
+//passes a threshold equal to it.
+//
+//at(threshold) returns a View with vertex_count() and adjacent(v), so the generic algorithms
+//(TraversalContext.hpp, VertexOrdering.hpp, CompressedGraph, ...) run on the graph at that
+//threshold. The second member of its (neighbor id, weight) pairs is the similarity, not the
+//1 - similarity distance Graph stores.
+class ThresholdGraph {
+public:
+    using Entry = std::pair<uint32_t, float>;   /**< (neighbor id, similarity). */
+
+    //Class that defines a contiguous run of adjacency entries.
+    class Range {
+    public:
+        Range(const Entry* first, const Entry* last) : first_(first), last_(last) {}
+
+        const Entry* begin() const { return first_; }
+        const Entry* end() const { return last_; }
+        size_t size() const { return static_cast<size_t>(last_ - first_); }
+        bool empty() const { return first_ == last_; }
+        const Entry& operator[](size_t i) const { return first_[i]; }
+
+    private:
+        const Entry* first_;
+        const Entry* last_;
+    };
+
+    //Class that defines the graph restricted to the edges at or above one threshold.
+    class View {
+    public:
+        View(const ThresholdGraph& graph, double minSimilarity) : graph_(&graph), minSimilarity_(minSimilarity) {}
+
+        size_t vertex_count() const { return graph_->vertex_count(); }
+        Range adjacent(size_t v) const { return graph_->neighbors(v, minSimilarity_); }
+
+    private:
+        const ThresholdGraph* graph_;
+        double minSimilarity_;
+    };
+
+    ThresholdGraph() : offsets_(1, 0) {}
+
+    //Takes lists that are already in CSR form: offsets[v]..offsets[v + 1] delimit v's entries,
+    //which must be sorted by descending similarity.
+    ThresholdGraph(std::vector<uint64_t>&& offsets, std::vector<Entry>&& entries)
+        : offsets_(std::move(offsets)), entries_(std::move(entries)) {}
+
+    //Copies a similarity graph whose weights are 1 - similarity (as SimilarityGraphBuilder makes
+    //them); the graph type needs vertex_count() and adjacent(v) returning (neighbor id, weight) pairs.
+    template <typename GraphType>
+    explicit ThresholdGraph(const GraphType& graph)
+    {
+        const size_t n = graph.vertex_count();
+        offsets_.assign(n + 1, 0);
+        for (size_t v = 0; v < n; ++v) {
+            for (const auto& edge : graph.adjacent(v))
+                entries_.emplace_back(static_cast<uint32_t>(edge.first), static_cast<float>(1.0 - edge.second));
+            std::sort(entries_.begin() + offsets_[v], entries_.end(), descendingSimilarity);
+            offsets_[v + 1] = entries_.size();
+        }
+        entries_.shrink_to_fit();
+    }
+
+    //Returns the number of vertices.
+    size_t vertex_count() const
+    {
+        return offsets_.size() - 1;
+    }
+
+    //Returns every stored neighbor of a vertex, most similar first.
+    Range adjacent(size_t v) const
+    {
+        return Range(entries_.data() + offsets_[v], entries_.data() + offsets_[v + 1]);
+    }
+
+    //Returns the neighbors of a vertex whose similarity is at least minSimilarity, most similar first.
+    Range neighbors(size_t v, double minSimilarity) const
+    {
+        const Entry* first = entries_.data() + offsets_[v];
+        const Entry* last = entries_.data() + offsets_[v + 1];
+        const float threshold = static_cast<float>(minSimilarity);
+        return Range(first, std::partition_point(first, last, [threshold](const Entry& e) { return e.second >= threshold; }));
+    }
+
+    //Returns the graph restricted to the edges at or above a threshold.
+    View at(double minSimilarity) const
+    {
+        return View(*this, minSimilarity);
+    }
+
+    //Returns the number of adjacency entries (twice the number of edges) at or above a threshold.
+    size_t entry_count(double minSimilarity) const
+    {
+        size_t count = 0;
+        for (size_t v = 0; v < vertex_count(); ++v)
+            count += neighbors(v, minSimilarity).size();
+        return count;
+    }
+
+    //Returns the number of connected components at a threshold.
+    size_t component_count(double minSimilarity, TraversalContext& context) const
+    {
+        const size_t n = vertex_count();
+        std::vector<char> seen(n, 0);
+        std::vector<size_t> component;
+        size_t count = 0;
+        for (size_t v = 0; v < n; ++v) {
+            if (seen[v]) continue;
+            ++count;
+            component.clear();
+            breadthFirstOrder(at(minSimilarity), v, context, component);
+            for (size_t u : component)
+                seen[u] = 1;
+        }
+        return count;
+    }
+
+    //Appends the vertices reachable from the source at a threshold, in breadth-first order
+    //(most similar neighbors first), to `order`.
+    void bfs(size_t source, double minSimilarity, TraversalContext& context, std::vector<size_t>& order) const
+    {
+        if (source < vertex_count())
+            breadthFirstOrder(at(minSimilarity), source, context, order);
+    }
+
+    //Appends the vertices reachable from the source at a threshold, in depth-first order, to `order`.
+    void dfs(size_t source, double minSimilarity, TraversalContext& context, std::vector<size_t>& order) const
+    {
+        if (source < vertex_count())
+            depthFirstOrder(at(minSimilarity), source, context, order);
+    }
+
+    //Appends a fewest-edges path between two vertices at a threshold to `path`; returns false if there is none.
+    bool find_path_bfs(size_t source, size_t target, double minSimilarity, TraversalContext& context,
+                       std::vector<size_t>& path) const
+    {
+        if (source >= vertex_count() || target >= vertex_count()) return false;
+        return findPathBreadthFirstIds(at(minSimilarity), source, target, context, path);
+    }
+
+    //Appends a path between two vertices found by depth-first search at a threshold; returns false if there is none.
+    bool find_path_dfs(size_t source, size_t target, double minSimilarity, TraversalContext& context,
+                       std::vector<size_t>& path) const
+    {
+        if (source >= vertex_count() || target >= vertex_count()) return false;
+        return findPathDepthFirstIds(at(minSimilarity), source, target, context, path);
+    }
+
+    //Returns the number of bytes used by the offsets and entries.
+    size_t memory_bytes() const
+    {
+        return offsets_.size() * sizeof(uint64_t) + entries_.size() * sizeof(Entry);
+    }
+
+    //Orders entries by descending similarity, then ascending neighbor id.
+    static bool descendingSimilarity(const Entry& a, const Entry& b)
+    {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    }
+
+private:
+    std::vector<uint64_t> offsets_;     /**< First entry of every vertex, plus the total. */
+    std::vector<Entry> entries_;        /**< Every vertex's neighbors, most similar first. */
+};
+
+#endif
@@ -0,0 +1,250 @@
+#ifndef TRAVERSAL_CONTEXT_HPP
+#define TRAVERSAL_CONTEXT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//Class that defines reusable scratch space for traversals over dense vertex ids.
+//
+//Visited marks are epoch stamps: a vertex is visited when its stamp equals the current epoch, so
+//reset() forgets every mark in O(1) by bumping the epoch instead of clearing an array. The arrays
+//only grow, when a graph larger than any seen before is traversed; after that, traversals
+//through a context do not allocate. Parent entries are only meaningful for vertices reached in
+//the current epoch.
+class TraversalContext {
+public:
+
+    //Starts a new traversal over a graph with the given number of vertices.
+    void reset(size_t vertexCount)
+    {
+        if (stamp_.size() < vertexCount) {
+            stamp_.resize(vertexCount, 0);
+            parent_.resize(vertexCount, 0);
+        }
+        if (++epoch_ == 0) {
+            std::fill(stamp_.begin(), stamp_.end(), 0);
+            epoch_ = 1;
+        }
+        pending_.clear();
+    }
+
+    //Checks if a vertex was visited in this traversal.
+    bool visited(size_t v) const
+    {
+        return stamp_[v] == epoch_;
+    }
+
+    //Marks a vertex as visited.
+    void visit(size_t v)
+    {
+        stamp_[v] = epoch_;
+    }
+
+    //Returns the vertex a traversal reached v from.
+    size_t parent(size_t v) const
+    {
+        return parent_[v];
+    }
+
+    //Records the vertex a traversal reached v from.
+    void set_parent(size_t v, size_t p)
+    {
+        parent_[v] = static_cast<uint32_t>(p);
+    }
+
+    //Returns the queue or stack of vertices waiting to be expanded, emptied by reset().
+    std::vector<uint32_t>& pending()
+    {
+        return pending_;
+    }
+
+    //Returns a vector of ids for the caller's own use, e.g. to collect a result; reset() leaves it alone.
+    std::vector<size_t>& ids()
+    {
+        return ids_;
+    }
+
+private:
+    std::vector<uint32_t> stamp_;       /**< Epoch in which each vertex was last visited. */
+    std::vector<uint32_t> parent_;      /**< Predecessor of each vertex in the current traversal. */
+    std::vector<uint32_t> pending_;     /**< Frontier storage. */
+    std::vector<size_t> ids_;           /**< Caller scratch space. */
+    uint32_t epoch_ = 0;                /**< Current epoch; 0 is never current. */
+};
+
+//Class that defines a context borrowed from the calling thread's pool, returned when it goes out of scope.
+class TraversalContextLease {
+public:
+
+    //Takes a context from the calling thread's pool, creating one if the pool is empty.
+    TraversalContextLease()
+    {
+        auto& pool = threadPool();
+        if (pool.empty()) {
+            context_.reset(new TraversalContext());
+        } else {
+            context_ = std::move(pool.back());
+            pool.pop_back();
+        }
+    }
+
+    TraversalContextLease(const TraversalContextLease&) = delete;
+    TraversalContextLease& operator=(const TraversalContextLease&) = delete;
+
+    TraversalContextLease(TraversalContextLease&& other) noexcept
+        : context_(std::move(other.context_)) {}
+
+    //Gives the context back to the calling thread's pool.
+    ~TraversalContextLease()
+    {
+        if (context_)
+            threadPool().push_back(std::move(context_));
+    }
+
+    TraversalContext& operator*() const
+    {
+        return *context_;
+    }
+
+    TraversalContext* operator->() const
+    {
+        return context_.get();
+    }
+
+private:
+
+    //Contexts not in use on this thread. Nested traversals each lease their own, so a thread
+    //holds as many as its deepest nesting and reuses them from then on.
+    static std::vector<std::unique_ptr<TraversalContext>>& threadPool()
+    {
+        thread_local std::vector<std::unique_ptr<TraversalContext>> pool;
+        return pool;
+    }
+
+    std::unique_ptr<TraversalContext> context_;     /**< The borrowed context. */
+};
+
+// Traversals over dense vertex ids that keep their state in a
+// TraversalContext. The graph type needs vertex_count() and adjacent(v)
+// returning a range of (neighbor id, weight) pairs. Each one visits vertices
+// in exactly the order of its title-based counterpart in GraphTraversal.hpp,
+// and appends its result to `out`. Once the context and `out` have grown to
+// size, none of them allocates.
+//
+// Each also takes an optional vertex filter, any type with test(v) such as a
+// Bitmap of allowed ids: vertices it rejects are never visited, expanded or
+// passed through, so the traversal runs on the subgraph the filter allows
+// and only pays for the edges of the allowed vertices it reaches. A
+// rejected source gives an empty result.
+
+//Vertex filter that allows every vertex.
+struct AllVertices {
+    bool test(size_t) const { return true; }
+};
+
+//Appends the vertices reachable from the source in breadth-first order.
+template <typename GraphType, typename VertexFilter = AllVertices>
+void breadthFirstOrder(const GraphType& graph, size_t source, TraversalContext& context, std::vector<size_t>& out,
+                       const VertexFilter& allowed = VertexFilter()) {
+    context.reset(graph.vertex_count());
+    if (!allowed.test(source)) return;
+    auto& queue = context.pending();
+    context.visit(source);
+    queue.push_back(static_cast<uint32_t>(source));
+    for (size_t head = 0; head < queue.size(); ++head) {
+        size_t current = queue[head];
+        out.push_back(current);
+        for (const auto& edge : graph.adjacent(current)) {
+            if (!context.visited(edge.first) && allowed.test(edge.first)) {
+                context.visit(edge.first);
+                queue.push_back(static_cast<uint32_t>(edge.first));
+            }
+        }
+    }
+}
+
+//Appends the vertices reachable from the source in depth-first order.
+template <typename GraphType, typename VertexFilter = AllVertices>
+void depthFirstOrder(const GraphType& graph, size_t source, TraversalContext& context, std::vector<size_t>& out,
+                     const VertexFilter& allowed = VertexFilter()) {
+    context.reset(graph.vertex_count());
+    if (!allowed.test(source)) return;
+    auto& stack = context.pending();
+    stack.push_back(static_cast<uint32_t>(source));
+    while (!stack.empty()) {
+        size_t current = stack.back();
+        stack.pop_back();
+        if (context.visited(current)) continue;
+        context.visit(current);
+        out.push_back(current);
+        for (const auto& edge : graph.adjacent(current)) {
+            if (!context.visited(edge.first) && allowed.test(edge.first)) stack.push_back(static_cast<uint32_t>(edge.first));
+        }
+    }
+}
+
+//Appends the path from the context's parent links, from source to target.
+inline void appendParentPath(const TraversalContext& context, size_t source, size_t target, std::vector<size_t>& out) {
+    size_t first = out.size();
+    for (size_t v = target; v != source; v = context.parent(v))
+        out.push_back(v);
+    out.push_back(source);
+    std::reverse(out.begin() + first, out.end());
+}
+
+//Appends a path between two vertices found by breadth-first search; returns false if there is none.
+template <typename GraphType, typename VertexFilter = AllVertices>
+bool findPathBreadthFirstIds(const GraphType& graph, size_t source, size_t target, TraversalContext& context,
+                             std::vector<size_t>& out, const VertexFilter& allowed = VertexFilter()) {
+    context.reset(graph.vertex_count());
+    if (!allowed.test(source) || !allowed.test(target)) return false;
+    auto& queue = context.pending();
+    context.visit(source);
+    queue.push_back(static_cast<uint32_t>(source));
+    for (size_t head = 0; head < queue.size(); ++head) {
+        size_t current = queue[head];
+        if (current == target) {
+            appendParentPath(context, source, target, out);
+            return true;
+        }
+        for (const auto& edge : graph.adjacent(current)) {
+            if (!context.visited(edge.first) && allowed.test(edge.first)) {
+                context.visit(edge.first);
+                context.set_parent(edge.first, current);
+                queue.push_back(static_cast<uint32_t>(edge.first));
+            }
+        }
+    }
+    return false;
+}
+
+//Appends a path between two vertices found by depth-first search; returns false if there is none.
+template <typename GraphType, typename VertexFilter = AllVertices>
+bool findPathDepthFirstIds(const GraphType& graph, size_t source, size_t target, TraversalContext& context,
+                           std::vector<size_t>& out, const VertexFilter& allowed = VertexFilter()) {
+    context.reset(graph.vertex_count());
+    if (!allowed.test(source) || !allowed.test(target)) return false;
+    auto& stack = context.pending();
+    stack.push_back(static_cast<uint32_t>(source));
+    while (!stack.empty()) {
+        size_t current = stack.back();
+        stack.pop_back();
+        if (context.visited(current)) continue;
+        context.visit(current);
+        if (current == target) {
+            appendParentPath(context, source, target, out);
+            return true;
+        }
+        for (const auto& edge : graph.adjacent(current)) {
+            if (!context.visited(edge.first) && allowed.test(edge.first)) {
+                context.set_parent(edge.first, current);
+                stack.push_back(static_cast<uint32_t>(edge.first));
+            }
+        }
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef VERTEX_ORDERING_HPP
+#define VERTEX_ORDERING_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Vertex orderings that give the vertices a traversal touches together
+// nearby ids, so their adjacency lists and per-vertex arrays (visited marks,
+// distances) share cache lines and pages. Each returns `order`, where
+// order[i] is the current id of the vertex that goes to position i; pass it
+// to Graph::reorder. The graph type needs vertex_count() and adjacent(v)
+// returning a range of (neighbor id, weight) pairs.
+
+//Breadth-first order: each component in BFS order from its lowest id, in adjacency order.
+template <typename GraphType>
+std::vector<size_t> breadthFirstOrdering(const GraphType& graph) {
+    const size_t n = graph.vertex_count();
+    std::vector<size_t> order;
+    order.reserve(n);
+    std::vector<char> placed(n, 0);
+    for (size_t root = 0; root < n; ++root) {
+        if (placed[root]) continue;
+        placed[root] = 1;
+        order.push_back(root);
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            for (const auto& edge : graph.adjacent(order[head])) {
+                if (!placed[edge.first]) {
+                    placed[edge.first] = 1;
+                    order.push_back(edge.first);
+                }
+            }
+        }
+    }
+    return order;
+}
+
+//Reverse Cuthill-McKee order: each component is traversed breadth-first from a lowest-degree
+//vertex, neighbors in ascending degree, and the whole sequence is reversed. Adjacent vertices
+//end up close together, which keeps the bandwidth max |id(u) - id(v)| over the edges small.
+template <typename GraphType>
+std::vector<size_t> reverseCuthillMcKeeOrdering(const GraphType& graph) {
+    const size_t n = graph.vertex_count();
+    std::vector<size_t> degree(n);
+    for (size_t v = 0; v < n; ++v) degree[v] = graph.adjacent(v).size();
+
+    // Roots in ascending degree, so every component starts from one of its lowest-degree vertices
+    std::vector<size_t> roots(n);
+    std::iota(roots.begin(), roots.end(), 0);
+    std::stable_sort(roots.begin(), roots.end(), [&degree](size_t a, size_t b) { return degree[a] < degree[b]; });
+
+    std::vector<size_t> order;
+    order.reserve(n);
+    std::vector<char> placed(n, 0);
+    std::vector<size_t> next;
+    for (size_t root : roots) {
+        if (placed[root]) continue;
+        placed[root] = 1;
+        order.push_back(root);
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            next.clear();
+            for (const auto& edge : graph.adjacent(order[head])) {
+                if (!placed[edge.first]) {
+                    placed[edge.first] = 1;
+                    next.push_back(edge.first);
+                }
+            }
+            std::stable_sort(next.begin(), next.end(), [&degree](size_t a, size_t b) { return degree[a] < degree[b]; });
+            order.insert(order.end(), next.begin(), next.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+//Degree order: highest degree first (ties keep their current order), which packs the
+//vertices most traversals reach into the first cache lines.
+template <typename GraphType>
+std::vector<size_t> degreeOrdering(const GraphType& graph) {
+    const size_t n = graph.vertex_count();
+    std::vector<size_t> degree(n);
+    for (size_t v = 0; v < n; ++v) degree[v] = graph.adjacent(v).size();
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&degree](size_t a, size_t b) { return degree[a] > degree[b]; });
+    return order;
+}
+
+//Mean |id(u) - id(v)| over the adjacency entries, a measure of how scattered neighbor accesses are.
+template <typename GraphType>
+double meanEdgeSpan(const GraphType& graph) {
+    double total = 0.0;
+    size_t entries = 0;
+    for (size_t v = 0; v < graph.vertex_count(); ++v) {
+        for (const auto& edge : graph.adjacent(v)) {
+            total += edge.first > v ? edge.first - v : v - edge.first;
+            ++entries;
+        }
+    }
+    return entries == 0 ? 0.0 : total / entries;
+}
+
+#endif
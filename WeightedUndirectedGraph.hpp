@@ -8,35 +8,657 @@
 #include <stack>
 #include <algorithm>
 #include "Movie.hpp" // Include Movie.hpp
+#include "GraphTraversal.hpp"
+#include "GraphFile.hpp"
+#include "ShortestPath.hpp"
+#include "DirectionOptimizingBfs.hpp"
+#include "ParallelTraversal.hpp"
+#include "MultiSourceBfs.hpp"
+#include "LandmarkOracle.hpp"
+#include "TraversalContext.hpp"
+#include "LazyTraversal.hpp"
+#include "VertexOrdering.hpp"
+#include "Bitmap.hpp"
+#include "GraphFingerprint.hpp"
 
 using namespace std;
 
 class Graph {
 private:
-    unordered_map<string, vector<pair<string, double>>> adjacencyList;
+    vector<vector<pair<size_t, double>>> adjacency_;
     vector<string> vertices_;
     unordered_map<string, size_t> mapping_;
 
+    // mirror_[v][i] is the position of v's entry in the list of its i-th
+    // neighbor, so an entry and its mirror entry are unlinked in O(1)
+    // without scanning either list.
+    vector<vector<uint32_t>> mirror_;
+
+    // Connected components, kept up to date by every mutation: componentOf_[v]
+    // is the label of v's component, componentMembers_[c] lists the vertices
+    // labeled c and memberIndex_[v] is v's position in that list. An edge
+    // between two components relabels the smaller one, so over any sequence
+    // of additions a vertex is relabeled O(log n) times; a removal relabels
+    // only the pieces that split off (see split_components). Lookups are one
+    // read, and the labels of emptied components are reused.
+    vector<size_t> componentOf_;
+    vector<size_t> memberIndex_;
+    vector<vector<size_t>> componentMembers_;
+    vector<size_t> freeComponents_;
+    size_t componentCount_ = 0;
+
+    // Set by sort_adjacency_by_weight: every list stays in ascending weight order.
+    bool weightOrdered_ = false;
+
+    // Bumped by every change to the vertices, their ids or the edges (see version()).
+    uint64_t version_ = 0;
+
+    // Number of adjacency entries and the sum of their fingerprintEntry
+    // hashes, updated by link and unlink (see fingerprint()).
+    uint64_t entryCount_ = 0;
+    uint64_t entryHash_ = 0;
+
+    static constexpr uint32_t kUnpaired = static_cast<uint32_t>(-1);
+
+    size_t find_component(size_t v) const {
+        return componentOf_[v];
+    }
+
+    // Adds v to component c.
+    void attach_to_component(size_t v, size_t c) {
+        if (componentMembers_[c].empty()) ++componentCount_;
+        componentOf_[v] = c;
+        memberIndex_[v] = componentMembers_[c].size();
+        componentMembers_[c].push_back(v);
+    }
+
+    // Takes v out of its component, freeing the label if it was the last member.
+    void detach_from_component(size_t v) {
+        size_t c = componentOf_[v];
+        auto& members = componentMembers_[c];
+        size_t moved = members.back();
+        members[memberIndex_[v]] = moved;
+        memberIndex_[moved] = memberIndex_[v];
+        members.pop_back();
+        if (members.empty()) {
+            freeComponents_.push_back(c);
+            --componentCount_;
+        }
+    }
+
+    // Returns an unused component label.
+    size_t new_component() {
+        if (!freeComponents_.empty()) {
+            size_t c = freeComponents_.back();
+            freeComponents_.pop_back();
+            return c;
+        }
+        componentMembers_.emplace_back();
+        return componentMembers_.size() - 1;
+    }
+
+    void unite_components(size_t v1, size_t v2) {
+        size_t c1 = componentOf_[v1];
+        size_t c2 = componentOf_[v2];
+        if (c1 == c2) return;
+        if (componentMembers_[c1].size() < componentMembers_[c2].size()) swap(c1, c2);
+        for (size_t u : componentMembers_[c2]) {
+            componentOf_[u] = c1;
+            memberIndex_[u] = componentMembers_[c1].size();
+            componentMembers_[c1].push_back(u);
+        }
+        vector<size_t>().swap(componentMembers_[c2]);
+        freeComponents_.push_back(c2);
+        --componentCount_;
+    }
+
+    // Points the mirror entries of u's entries from `first` on back at them,
+    // after entries from `first` on moved within u's list. Entries marked
+    // kUnpaired are skipped. A self-loop entry's mirror is in the same list,
+    // so it is first adjusted by `shift` if it points at a moved entry.
+    void repair_mirrors(size_t u, size_t first, int shift) {
+        auto& list = adjacency_[u];
+        auto& mirror = mirror_[u];
+        const size_t moved = shift > 0 ? first - 1 : first + 1;  // first old position that moved
+        for (size_t k = first; k < list.size(); ++k) {
+            if (list[k].first == u && mirror[k] != kUnpaired && mirror[k] >= moved) {
+                mirror[k] = static_cast<uint32_t>(mirror[k] + shift);
+            }
+        }
+        for (size_t k = first; k < list.size(); ++k) {
+            if (mirror[k] != kUnpaired) mirror_[list[k].first][mirror[k]] = static_cast<uint32_t>(k);
+        }
+    }
+
+    // Removes the i-th entry of u's list; its mirror entry is the caller's.
+    // The last entry moves into the gap in O(1), except in weight-ordered
+    // lists, which shift the later entries down to stay sorted (O(degree)).
+    void unlink(size_t u, size_t i) {
+        auto& list = adjacency_[u];
+        auto& mirror = mirror_[u];
+        entryHash_ -= fingerprintEntry(u, list[i].first, list[i].second);
+        --entryCount_;
+        if (weightOrdered_) {
+            list.erase(list.begin() + i);
+            mirror.erase(mirror.begin() + i);
+            repair_mirrors(u, i, -1);
+            return;
+        }
+        size_t last = list.size() - 1;
+        if (i != last) {
+            list[i] = list[last];
+            mirror[i] = mirror[last];
+            mirror_[list[i].first][mirror[i]] = static_cast<uint32_t>(i);
+        }
+        list.pop_back();
+        mirror.pop_back();
+    }
+
+    // Appends (v, weight) to u's list, or inserts it after every entry of no
+    // greater weight in weight-ordered lists; returns its position. The new
+    // entry is kUnpaired until the caller sets its mirror.
+    size_t link(size_t u, size_t v, double weight) {
+        auto& list = adjacency_[u];
+        auto& mirror = mirror_[u];
+        entryHash_ += fingerprintEntry(u, v, weight);
+        ++entryCount_;
+        if (!weightOrdered_) {
+            list.emplace_back(v, weight);
+            mirror.push_back(kUnpaired);
+            return list.size() - 1;
+        }
+        size_t at = upper_bound(list.begin(), list.end(), weight,
+                                [](double w, const pair<size_t, double>& entry) { return w < entry.second; }) -
+                    list.begin();
+        list.emplace(list.begin() + at, v, weight);
+        mirror.insert(mirror.begin() + at, kUnpaired);
+        repair_mirrors(u, at + 1, 1);
+        return at;
+    }
+
+    static void sort_by_weight(vector<vector<pair<size_t, double>>>& adjacency) {
+        for (auto& list : adjacency) {
+            sort(list.begin(), list.end(), [](const pair<size_t, double>& a, const pair<size_t, double>& b) {
+                return a.second != b.second ? a.second < b.second : a.first < b.first;
+            });
+        }
+    }
+
+    // Pairs every entry with its mirror entry: the k-th entry of u for x with
+    // the k-th entry of x for u (self-loop entries in consecutive pairs).
+    // Returns false, leaving `mirror` unspecified, if the lists are not
+    // symmetric or name a vertex that does not exist.
+    static bool pair_entries(const vector<vector<pair<size_t, double>>>& adjacency, vector<vector<uint32_t>>& mirror) {
+        const size_t n = adjacency.size();
+        mirror.assign(n, {});
+        for (size_t u = 0; u < n; ++u) {
+            mirror[u].assign(adjacency[u].size(), kUnpaired);
+        }
+
+        // Entries pointing to a higher id, grouped by that id, in ascending order of the lower one
+        vector<size_t> waitingStart(n + 1, 0);
+        for (size_t u = 0; u < n; ++u) {
+            for (const auto& entry : adjacency[u]) {
+                if (entry.first >= n) return false;
+                if (entry.first > u) ++waitingStart[entry.first + 1];
+            }
+        }
+        for (size_t x = 0; x < n; ++x) {
+            waitingStart[x + 1] += waitingStart[x];
+        }
+        vector<pair<uint32_t, uint32_t>> waiting(waitingStart[n]);
+        vector<size_t> fill(waitingStart.begin(), waitingStart.end() - 1);
+        for (size_t u = 0; u < n; ++u) {
+            for (size_t i = 0; i < adjacency[u].size(); ++i) {
+                size_t x = adjacency[u][i].first;
+                if (x > u) waiting[fill[x]++] = { static_cast<uint32_t>(u), static_cast<uint32_t>(i) };
+            }
+        }
+
+        // Each vertex takes its entries for lower ids, in list order, from the
+        // waiting entries of that id; next[x] is the next unmatched one of x
+        vector<size_t> next(n, 0);
+        for (size_t u = 0; u < n; ++u) {
+            for (size_t w = waitingStart[u + 1]; w-- > waitingStart[u];) {
+                next[waiting[w].first] = w;
+            }
+            size_t matched = 0;
+            size_t selfLoop = npos;
+            for (size_t i = 0; i < adjacency[u].size(); ++i) {
+                size_t x = adjacency[u][i].first;
+                if (x == u) {
+                    if (selfLoop == npos) {
+                        selfLoop = i;
+                    } else {
+                        mirror[u][i] = static_cast<uint32_t>(selfLoop);
+                        mirror[u][selfLoop] = static_cast<uint32_t>(i);
+                        selfLoop = npos;
+                    }
+                } else if (x < u) {
+                    size_t w = next[x];
+                    if (w >= waitingStart[u + 1] || waiting[w].first != x) return false;
+                    ++next[x];
+                    ++matched;
+                    mirror[u][i] = waiting[w].second;
+                    mirror[x][waiting[w].second] = static_cast<uint32_t>(i);
+                }
+            }
+            if (selfLoop != npos || matched != waitingStart[u + 1] - waitingStart[u]) return false;
+        }
+        return true;
+    }
+
+    // Checks that a filter bitmap has exactly one bit per vertex id, as one
+    // built for this graph does; any other size is rejected with a message.
+    bool covers(const Bitmap& allowed) const {
+        if (allowed.size() != vertices_.size()) {
+            std::cout << "Filter bitmap size does not match the number of vertices" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Relabels the pieces a component split into after a removal. `seeds` are
+    // the ends of the removed edges, all in one component. A search runs from
+    // each seed, round-robin one vertex at a time; searches that meet are
+    // merged into a group, and a group that runs out of vertices has found a
+    // whole piece. Once at most one group is still running, its piece keeps
+    // the label and every finished piece gets a new one. The work is bounded
+    // by the finished pieces (times the number of seeds), not by the size of
+    // the component, and a component that stays whole is usually confirmed
+    // within the seeds' first lists.
+    void split_components(const vector<size_t>& seeds) {
+        TraversalContextLease context;
+        context->reset(vertices_.size());
+        vector<size_t> starts;
+        for (size_t seed : seeds) {
+            if (context->visited(seed)) continue;
+            context->visit(seed);
+            context->set_parent(seed, starts.size());
+            starts.push_back(seed);
+        }
+        const size_t k = starts.size();
+        if (k < 2) return;
+
+        // found[i] holds search i's vertices in BFS order, expanded up to head[i];
+        // the context's parent slot of a found vertex holds its search
+        vector<vector<size_t>> found(k);
+        vector<size_t> head(k, 0), group(k), active(k, 1);
+        for (size_t i = 0; i < k; ++i) {
+            found[i].push_back(starts[i]);
+            group[i] = i;
+        }
+        auto root = [&group](size_t i) {
+            while (group[i] != i) i = group[i] = group[group[i]];
+            return i;
+        };
+        size_t running = k;
+        while (running > 1) {
+            for (size_t i = 0; i < k && running > 1; ++i) {
+                if (head[i] == found[i].size()) continue;
+                size_t current = found[i][head[i]++];
+                for (const auto& edge : adjacency_[current]) {
+                    size_t u = edge.first;
+                    if (!context->visited(u)) {
+                        context->visit(u);
+                        context->set_parent(u, i);
+                        found[i].push_back(u);
+                    } else {
+                        size_t a = root(i), b = root(context->parent(u));
+                        if (a != b) {
+                            group[b] = a;
+                            active[a] += active[b];
+                            --running;
+                        }
+                    }
+                }
+                if (head[i] == found[i].size() && --active[root(i)] == 0) --running;
+            }
+        }
+
+        // Finished groups are whole pieces; the one still running keeps the label
+        vector<size_t> label(k, npos);
+        for (size_t i = 0; i < k; ++i) {
+            size_t r = root(i);
+            if (active[r] != 0) continue;
+            if (label[r] == npos) label[r] = new_component();
+            for (size_t v : found[i]) {
+                detach_from_component(v);
+                attach_to_component(v, label[r]);
+            }
+        }
+    }
+
+    void append_titles(const vector<size_t>& ids, vector<string>& titles) const {
+        titles.reserve(titles.size() + ids.size());
+        for (size_t v : ids) {
+            titles.push_back(vertices_[v]);
+        }
+    }
+
+    // Recomputes the entry count and hash after the edges or ids were replaced wholesale.
+    void rehash_entries() {
+        GraphFingerprint full = computeGraphFingerprint(*this);
+        entryCount_ = full.entryCount;
+        entryHash_ = full.hash;
+    }
+
+    // Recomputes every label after a bulk replacement of the edges.
+    void rebuild_components() {
+        ThreadPool pool;
+        vector<size_t> root = parallelConnectedComponents(*this, pool);
+        const size_t n = vertices_.size();
+        componentOf_.assign(n, npos);
+        memberIndex_.assign(n, 0);
+        componentMembers_.clear();
+        freeComponents_.clear();
+        componentCount_ = 0;
+        vector<size_t> label(n, npos);
+        for (size_t v = 0; v < n; ++v) {
+            if (label[root[v]] == npos) {
+                label[root[v]] = componentMembers_.size();
+                componentMembers_.emplace_back();
+            }
+            attach_to_component(v, label[root[v]]);
+        }
+    }
+
 public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
     void add_vertex(const string& v) {
         if (contains_vertex(v)) {
             std::cout << "Vertex with the same id already exists" << std::endl;
             return;
         }        
         vertices_.push_back(v);
+        adjacency_.emplace_back();
+        mirror_.emplace_back();
         mapping_[v] = vertices_.size() - 1;
+        componentOf_.push_back(npos);
+        memberIndex_.push_back(0);
+        attach_to_component(vertices_.size() - 1, new_component());
+        ++version_;
     }
 
     void add_edge(const string& movie1, const string& movie2, double weight) {
-        adjacencyList[movie1].emplace_back(movie2, weight);
-        adjacencyList[movie2].emplace_back(movie1, weight);
+        size_t v1 = vertex_id(movie1);
+        size_t v2 = vertex_id(movie2);
+        if (v1 == npos || v2 == npos) {
+            std::cout << "One or more vertices do not exist" << std::endl;
+            return;
+        }
+        add_edge(v1, v2, weight);
+    }
+
+    void add_edge(size_t v1, size_t v2, double weight) {
+        if (v1 >= vertices_.size() || v2 >= vertices_.size()) {
+            std::cout << "One or more vertices do not exist" << std::endl;
+            return;
+        }
+        size_t i1 = link(v1, v2, weight);
+        size_t i2 = link(v2, v1, weight);
+        if (v1 == v2 && i2 <= i1) ++i1;
+        mirror_[v1][i1] = static_cast<uint32_t>(i2);
+        mirror_[v2][i2] = static_cast<uint32_t>(i1);
+        unite_components(v1, v2);
+        ++version_;
+    }
+
+    // Removes every edge between two movies, in O(degree) of the first.
+    void remove_edge(const string& movie1, const string& movie2) {
+        size_t v1 = vertex_id(movie1);
+        size_t v2 = vertex_id(movie2);
+        if (v1 == npos || v2 == npos) {
+            std::cout << "One or more vertices do not exist" << std::endl;
+            return;
+        }
+
+        // From the back, so entries moved into a gap have been looked at already
+        bool found = false;
+        for (size_t i = adjacency_[v1].size(); i-- > 0;) {
+            if (i >= adjacency_[v1].size() || adjacency_[v1][i].first != v2) continue;
+            found = true;
+            size_t j = mirror_[v1][i];
+            if (v1 == v2) {
+                unlink(v1, max(i, j));
+                unlink(v1, min(i, j));
+            } else {
+                unlink(v2, j);
+                unlink(v1, i);
+            }
+        }
+        if (!found) {
+            std::cout << "The edge does not exist" << std::endl;
+            return;
+        }
+
+        // The component either stays whole or splits between the two ends
+        split_components({ v1, v2 });
+        ++version_;
+    }
+
+    // Removes a movie and its edges. Each edge is unlinked from the other
+    // end's list through its mirror entry in O(1), and the last vertex takes
+    // over the freed id, so the list edits cost O(degree) of the removed and
+    // the last vertex; ids other than the last stay valid. Lists the removal touches
+    // may change order (see unlink). Component labels change only for the
+    // pieces that split off (see split_components).
+    void remove_vertex(const string& movie) {
+        size_t v = vertex_id(movie);
+        if (v == npos) {
+            std::cout << "Vertex with the id does not exist" << std::endl;
+            return;
+        }
+
+        vector<size_t> seeds;
+        for (size_t i = 0; i < adjacency_[v].size(); ++i) {
+            size_t u = adjacency_[v][i].first;
+            if (u == v) continue;
+            seeds.push_back(u);
+            unlink(u, mirror_[v][i]);
+        }
+        for (const auto& edge : adjacency_[v]) {
+            entryHash_ -= fingerprintEntry(v, edge.first, edge.second);
+            --entryCount_;
+        }
+        vector<pair<size_t, double>>().swap(adjacency_[v]);
+        vector<uint32_t>().swap(mirror_[v]);
+        detach_from_component(v);
+        split_components(seeds);
+
+        mapping_.erase(movie);
+        size_t last = vertices_.size() - 1;
+        if (last != v) {
+            // Point last's mirror entries at its new id, then move it into the slot
+            for (size_t i = 0; i < adjacency_[last].size(); ++i) {
+                size_t u = adjacency_[last][i].first;
+                double weight = adjacency_[last][i].second;
+                entryHash_ -= fingerprintEntry(last, u, weight);
+                if (u == last) {
+                    adjacency_[last][i].first = v;
+                    entryHash_ += fingerprintEntry(v, v, weight);
+                } else {
+                    adjacency_[u][mirror_[last][i]].first = v;
+                    entryHash_ += fingerprintEntry(v, u, weight) + fingerprintEntry(u, v, weight) -
+                                  fingerprintEntry(u, last, weight);
+                }
+            }
+            adjacency_[v] = std::move(adjacency_[last]);
+            mirror_[v] = std::move(mirror_[last]);
+            vertices_[v] = std::move(vertices_[last]);
+            mapping_[vertices_[v]] = v;
+            componentOf_[v] = componentOf_[last];
+            memberIndex_[v] = memberIndex_[last];
+            componentMembers_[componentOf_[v]][memberIndex_[v]] = v;
+        }
+        adjacency_.pop_back();
+        mirror_.pop_back();
+        vertices_.pop_back();
+        componentOf_.pop_back();
+        memberIndex_.pop_back();
+        ++version_;
+    }
+
+    // Replaces every edge at once. adjacency[v] lists the (neighbor id, weight)
+    // pairs of vertex v and must hold one list per vertex, every edge listed
+    // at both ends; used by bulk builders.
+    void set_adjacency(vector<vector<pair<size_t, double>>>&& adjacency) {
+        if (adjacency.size() != vertices_.size()) {
+            std::cout << "Adjacency size does not match the number of vertices" << std::endl;
+            return;
+        }
+        if (weightOrdered_) sort_by_weight(adjacency);
+        vector<vector<uint32_t>> mirror;
+        if (!pair_entries(adjacency, mirror)) {
+            std::cout << "Adjacency lists are not symmetric" << std::endl;
+            return;
+        }
+        adjacency_ = std::move(adjacency);
+        mirror_ = std::move(mirror);
+        rebuild_components();
+        rehash_entries();
+        ++version_;
+    }
+
+    // Sorts every adjacency list by ascending weight (most similar first for a
+    // similarity graph; equal weights by neighbor id) and keeps them sorted:
+    // later add_edge calls insert at the weight's position. The k lightest
+    // edges of a vertex are then the first k entries of adjacent(v), and
+    // top_k_within_hops can run. Traversals follow the new neighbor order.
+    void sort_adjacency_by_weight() {
+        sort_by_weight(adjacency_);
+        pair_entries(adjacency_, mirror_);
+        weightOrdered_ = true;
+    }
+
+    bool weight_ordered() const {
+        return weightOrdered_;
+    }
+
+    // Relabels the vertices so that the vertex at id order[i] gets id i (see
+    // VertexOrdering.hpp for orderings). Adjacency lists are copied in the
+    // new order, so lists of nearby ids are also nearby in memory, and keep
+    // their entry order, so title-based traversals return the same sequence.
+    // Returns the new id of every old id, to translate ids held elsewhere, or
+    // an empty vector if `order` is not a permutation of the ids.
+    vector<size_t> reorder(const vector<size_t>& order) {
+        const size_t n = vertices_.size();
+        vector<size_t> newId(n, npos);
+        if (order.size() != n) {
+            std::cout << "Ordering size does not match the number of vertices" << std::endl;
+            return {};
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (order[i] >= n || newId[order[i]] != npos) {
+                std::cout << "Ordering is not a permutation of the vertex ids" << std::endl;
+                return {};
+            }
+            newId[order[i]] = i;
+        }
+
+        vector<string> vertices(n);
+        vector<vector<pair<size_t, double>>> adjacency(n);
+        vector<vector<uint32_t>> mirror(n);
+        vector<size_t> componentOf(n), memberIndex(n);
+        for (size_t i = 0; i < n; ++i) {
+            size_t v = order[i];
+            vertices[i] = std::move(vertices_[v]);
+            mapping_[vertices[i]] = i;
+            adjacency[i].reserve(adjacency_[v].size());
+            for (const auto& neighbor : adjacency_[v]) {
+                adjacency[i].emplace_back(newId[neighbor.first], neighbor.second);
+            }
+            vector<pair<size_t, double>>().swap(adjacency_[v]);
+            mirror[i] = std::move(mirror_[v]);
+            componentOf[i] = componentOf_[v];
+            memberIndex[i] = memberIndex_[v];
+        }
+        vertices_ = std::move(vertices);
+        adjacency_ = std::move(adjacency);
+        mirror_ = std::move(mirror);
+        componentOf_ = std::move(componentOf);
+        memberIndex_ = std::move(memberIndex);
+        for (auto& members : componentMembers_) {
+            for (auto& u : members) {
+                u = newId[u];
+            }
+        }
+        rehash_entries();
+        ++version_;
+        return newId;
+    }
+
+    size_t vertex_count() const {
+        return vertices_.size();
+    }
+
+    // Counter that changes whenever a vertex or edge is added or removed, the
+    // edges are replaced or the ids are reordered. It counts edits to this
+    // object only, so it tells a table built from the graph that the graph
+    // changed since, not that it is the same graph; use fingerprint() for that.
+    uint64_t version() const {
+        return version_;
+    }
+
+    // Identity of the vertex ids and edges (see GraphFingerprint.hpp), equal
+    // to computeGraphFingerprint(*this) but kept up to date by every edit, so
+    // it costs O(1).
+    GraphFingerprint fingerprint() const {
+        GraphFingerprint result;
+        result.vertexCount = vertices_.size();
+        result.entryCount = entryCount_;
+        result.hash = entryHash_;
+        return result;
+    }
+
+    const vector<string>& vertices() const {
+        return vertices_;
+    }
+
+    // Dense id of a vertex (its position in vertices()), or npos if absent.
+    size_t vertex_id(const string& v) const {
+        auto it = mapping_.find(v);
+        return it == mapping_.end() ? npos : it->second;
+    }
+
+    const vector<pair<size_t, double>>& adjacent(size_t v) const {
+        return adjacency_[v];
     }
 
     vector<pair<string, double>> getNeighbors(const string& movie) const {
-        if (adjacencyList.find(movie) != adjacencyList.end()) {
-            return adjacencyList.at(movie);
+        vector<pair<string, double>> result;
+        size_t v = vertex_id(movie);
+        if (v != npos) {
+            result.reserve(adjacency_[v].size());
+            for (const auto& neighbor : adjacency_[v]) {
+                result.emplace_back(vertices_[neighbor.first], neighbor.second);
+            }
+        }
+        return result;
+    }
+
+    // The k movies with the smallest path weight from a movie over paths of at
+    // most maxHops edges, nearest first, with their distances (best-first
+    // search over the sorted lists, see topKWithinHops in ShortestPath.hpp).
+    // Needs sort_adjacency_by_weight(); empty if the movie is absent.
+    vector<pair<string, double>> top_k_within_hops(const string& movie, size_t k, size_t maxHops) const {
+        vector<pair<string, double>> result;
+        size_t v = vertex_id(movie);
+        if (v == npos) return result;
+        TraversalContextLease context;
+        for (const auto& entry : top_k_within_hops(v, k, maxHops, *context)) {
+            result.emplace_back(vertices_[entry.first], entry.second);
         }
-        return {};
+        return result;
+    }
+
+    vector<pair<size_t, double>> top_k_within_hops(size_t v, size_t k, size_t maxHops, TraversalContext& context) const {
+        if (!weightOrdered_) {
+            std::cout << "Adjacency lists are not sorted by weight; call sort_adjacency_by_weight() first" << std::endl;
+            return {};
+        }
+        return topKWithinHops(*this, v, k, maxHops, context);
     }
 
     void displayAdjacent(const string& movie) const {
@@ -55,143 +677,312 @@ public:
         return mapping_.find(v) != mapping_.end();
     }
 
+    // Id of the connected component containing the movie, or npos if absent.
+    // Ids are opaque and only valid until the graph next changes: adding or
+    // removing an edge or vertex, or reorder(), may relabel components.
+    size_t component_of(const string& movie) const {
+        size_t v = vertex_id(movie);
+        return v == npos ? npos : find_component(v);
+    }
+
+    // Checks if a path exists between two movies: two title lookups and two
+    // component label reads, O(1).
+    bool same_component(const string& movie1, const string& movie2) const {
+        size_t c = component_of(movie1);
+        return c != npos && c == component_of(movie2);
+    }
+
+    bool same_component(size_t v1, size_t v2) const {
+        return v1 < vertices_.size() && v2 < vertices_.size() && find_component(v1) == find_component(v2);
+    }
+
+    size_t component_count() const {
+        return componentCount_;
+    }
+
     vector<string> bfs(const string& start) const {
         vector<string> result;
-        if (!contains_vertex(start)) return result;
-
-        unordered_map<string, bool> visited;
-        queue<string> q;
+        size_t source = vertex_id(start);
+        if (source == npos) return result;
+        TraversalContextLease context;
+        vector<size_t>& order = context->ids();
+        order.clear();
+        bfs(source, *context, order);
+        append_titles(order, result);
+        return result;
+    }
 
-        visited[start] = true;
-        q.push(start);
+    // bfs() over vertex ids: appends the ids reachable from the source to
+    // `order`. The context holds the visited marks and the queue, so a caller
+    // that keeps its context and output vector traverses without allocating.
+    void bfs(size_t source, TraversalContext& context, vector<size_t>& order) const {
+        if (source >= vertices_.size()) return;
+        breadthFirstOrder(*this, source, context, order);
+    }
 
-        while (!q.empty()) {
-            string current = q.front();
-            q.pop();
-            result.push_back(current);
+    // bfs() as a lazy traversal of vertex ids (see LazyTraversal.hpp) that
+    // does only the work needed for the vertices read from it, e.g.
+    //   for (size_t v : graph.bfs_lazy("Roma", limits)) ...
+    // The graph must not change while the traversal is in use.
+    BreadthFirstTraversal<Graph> bfs_lazy(const string& start, TraversalLimits limits = TraversalLimits()) const {
+        return BreadthFirstTraversal<Graph>(*this, vertex_id(start), std::move(limits));
+    }
 
-            for (const auto& neighbor : getNeighbors(current)) {
-                if (!visited[neighbor.first]) {
-                    visited[neighbor.first] = true;
-                    q.push(neighbor.first);
-                }
-            }
+    // Same vertices as bfs(), level by level, from a direction-optimizing
+    // search over vertex ids (see DirectionOptimizingBfs.hpp). Within a level
+    // vertices come in insertion order rather than discovery order.
+    vector<string> bfs_direction_optimizing(const string& start) const {
+        vector<string> result;
+        size_t source = vertex_id(start);
+        if (source == npos) return result;
+        for (size_t v : directionOptimizingBfs(*this, source)) {
+            result.push_back(vertices_[v]);
         }
         return result;
     }
 
-    vector<string> dfs(const string& start) const {
+    // Same vertices as bfs(), from a multi-threaded level-synchronous search
+    // (see ParallelTraversal.hpp); level by level, insertion order within a
+    // level. numThreads = 0 uses every hardware thread.
+    vector<string> bfs_parallel(const string& start, unsigned numThreads = 0) const {
         vector<string> result;
-        if (!contains_vertex(start)) return result;
-
-        unordered_map<string, bool> visited;
-        stack<string> s;
+        size_t source = vertex_id(start);
+        if (source == npos) return result;
+        ThreadPool pool(numThreads);
+        for (size_t v : parallelBfs(*this, source, pool)) {
+            result.push_back(vertices_[v]);
+        }
+        return result;
+    }
 
-        s.push(start);
+    // Runs bfs() from every start movie in one multi-source pass (see
+    // MultiSourceBfs.hpp). result[i] holds the movies reachable from
+    // starts[i], level by level, in insertion order within a level; it is
+    // empty for a movie that is not in the graph.
+    vector<vector<string>> bfs_batch(const vector<string>& starts, unsigned numThreads = 0) const {
+        vector<vector<uint32_t>> distance = hop_distances(starts, numThreads);
+
+        // Counting sort of the reached vertices by hop distance
+        vector<vector<string>> result(starts.size());
+        vector<size_t> levelStart;
+        vector<size_t> order;
+        for (size_t i = 0; i < starts.size(); ++i) {
+            levelStart.assign(1, 0);
+            for (uint32_t d : distance[i]) {
+                if (d == kUnreachable) continue;
+                if (d + 2 > levelStart.size()) levelStart.resize(d + 2, 0);
+                ++levelStart[d + 1];
+            }
+            for (size_t level = 1; level < levelStart.size(); ++level) {
+                levelStart[level] += levelStart[level - 1];
+            }
+            order.resize(levelStart.back());
+            for (size_t v = 0; v < vertices_.size(); ++v) {
+                if (distance[i][v] != kUnreachable) order[levelStart[distance[i][v]]++] = v;
+            }
+            result[i].reserve(order.size());
+            for (size_t v : order) {
+                result[i].push_back(vertices_[v]);
+            }
+        }
+        return result;
+    }
 
-        while (!s.empty()) {
-            string current = s.top();
-            s.pop();
+    // Hop distance from every start movie to every vertex id, kUnreachable
+    // where there is no path; the multi-source pass behind bfs_batch without
+    // building any titles.
+    vector<vector<uint32_t>> hop_distances(const vector<string>& starts, unsigned numThreads = 0) const {
+        vector<size_t> sources;
+        for (const auto& start : starts) {
+            sources.push_back(vertex_id(start));
+        }
+        ThreadPool pool(numThreads);
+        return multiSourceBfs(*this, sources, pool);
+    }
 
-            if (!visited[current]) {
-                visited[current] = true;
-                result.push_back(current);
+    // Component label of every vertex id, computed with a multi-threaded
+    // union-find: the smallest vertex id in the vertex's component.
+    vector<size_t> connected_components(unsigned numThreads = 0) const {
+        ThreadPool pool(numThreads);
+        return parallelConnectedComponents(*this, pool);
+    }
 
-                for (const auto& neighbor : getNeighbors(current)) {
-                    if (!visited[neighbor.first]) {
-                        s.push(neighbor.first);
-                    }
-                }
-            }
-        }
+    vector<string> dfs(const string& start) const {
+        vector<string> result;
+        size_t source = vertex_id(start);
+        if (source == npos) return result;
+        TraversalContextLease context;
+        vector<size_t>& order = context->ids();
+        order.clear();
+        dfs(source, *context, order);
+        append_titles(order, result);
         return result;
     }
 
+    // dfs() as a lazy traversal of vertex ids; see bfs_lazy().
+    DepthFirstTraversal<Graph> dfs_lazy(const string& start, TraversalLimits limits = TraversalLimits()) const {
+        return DepthFirstTraversal<Graph>(*this, vertex_id(start), std::move(limits));
+    }
+
+    // dfs() over vertex ids, appending to `order`; see bfs(size_t, ...).
+    void dfs(size_t source, TraversalContext& context, vector<size_t>& order) const {
+        if (source >= vertices_.size()) return;
+        depthFirstOrder(*this, source, context, order);
+    }
+
     bool find_path_bfs(const string& start, const string& end, vector<string>& path) const {
-        if (!contains_vertex(start) || !contains_vertex(end)) return false;
+        if (!same_component(start, end)) return false;
+        TraversalContextLease context;
+        vector<size_t>& ids = context->ids();
+        ids.clear();
+        if (!find_path_bfs(vertex_id(start), vertex_id(end), *context, ids)) return false;
+        append_titles(ids, path);
+        return true;
+    }
 
-        unordered_map<string, bool> visited;
-        unordered_map<string, string> parent;
-        queue<string> q;
+    // find_path_bfs() over vertex ids, appending the path to `path`.
+    bool find_path_bfs(size_t start, size_t end, TraversalContext& context, vector<size_t>& path) const {
+        if (!same_component(start, end)) return false;
+        return findPathBreadthFirstIds(*this, start, end, context, path);
+    }
 
-        visited[start] = true;
-        q.push(start);
-        parent[start] = "";
+    bool find_path_dfs(const string& start, const string& end, vector<string>& path) const {
+        if (!same_component(start, end)) return false;
+        TraversalContextLease context;
+        vector<size_t>& ids = context->ids();
+        ids.clear();
+        if (!find_path_dfs(vertex_id(start), vertex_id(end), *context, ids)) return false;
+        append_titles(ids, path);
+        return true;
+    }
 
-        while (!q.empty()) {
-            string current = q.front();
-            q.pop();
+    // find_path_dfs() over vertex ids, appending the path to `path`.
+    bool find_path_dfs(size_t start, size_t end, TraversalContext& context, vector<size_t>& path) const {
+        if (!same_component(start, end)) return false;
+        return findPathDepthFirstIds(*this, start, end, context, path);
+    }
 
-            if (current == end) {
-                string step = end;
-                while (!step.empty()) {
-                    path.push_back(step);
-                    step = parent[step];
-                }
-                reverse(path.begin(), path.end());
-                return true;
-            }
+    // Traversals restricted to the movies in `allowed`, a Bitmap over vertex
+    // ids (see PlatformFilters): other movies are never visited, expanded or
+    // passed through, so the work is bounded by the allowed movies reached
+    // and their edges. Each returns what its unfiltered form returns on the
+    // subgraph of allowed movies; nothing if the start or end is not allowed.
+    // `allowed` must have one bit per vertex (size() == vertex_count()), so a
+    // bitmap built before vertices were added or removed is rejected.
+    vector<string> bfs(const string& start, const Bitmap& allowed) const {
+        vector<string> result;
+        size_t source = vertex_id(start);
+        if (source == npos) return result;
+        TraversalContextLease context;
+        vector<size_t>& order = context->ids();
+        order.clear();
+        bfs(source, allowed, *context, order);
+        append_titles(order, result);
+        return result;
+    }
 
-            for (const auto& neighbor : getNeighbors(current)) {
-                if (!visited[neighbor.first]) {
-                    visited[neighbor.first] = true;
-                    parent[neighbor.first] = current;
-                    q.push(neighbor.first);
-                }
-            }
-        }
-        return false;
+    void bfs(size_t source, const Bitmap& allowed, TraversalContext& context, vector<size_t>& order) const {
+        if (source >= vertices_.size() || !covers(allowed)) return;
+        breadthFirstOrder(*this, source, context, order, allowed);
     }
 
-    bool find_path_dfs(const string& start, const string& end, vector<string>& path) const {
-        if (!contains_vertex(start) || !contains_vertex(end)) return false;
+    vector<string> dfs(const string& start, const Bitmap& allowed) const {
+        vector<string> result;
+        size_t source = vertex_id(start);
+        if (source == npos) return result;
+        TraversalContextLease context;
+        vector<size_t>& order = context->ids();
+        order.clear();
+        dfs(source, allowed, *context, order);
+        append_titles(order, result);
+        return result;
+    }
 
-        unordered_map<string, bool> visited;
-        unordered_map<string, string> parent;
-        stack<string> s;
+    void dfs(size_t source, const Bitmap& allowed, TraversalContext& context, vector<size_t>& order) const {
+        if (source >= vertices_.size() || !covers(allowed)) return;
+        depthFirstOrder(*this, source, context, order, allowed);
+    }
 
-        s.push(start);
-        parent[start] = "";
+    bool find_path_bfs(const string& start, const string& end, vector<string>& path, const Bitmap& allowed) const {
+        if (!same_component(start, end)) return false;
+        TraversalContextLease context;
+        vector<size_t>& ids = context->ids();
+        ids.clear();
+        if (!find_path_bfs(vertex_id(start), vertex_id(end), allowed, *context, ids)) return false;
+        append_titles(ids, path);
+        return true;
+    }
 
-        while (!s.empty()) {
-            string current = s.top();
-            s.pop();
+    bool find_path_bfs(size_t start, size_t end, const Bitmap& allowed, TraversalContext& context,
+                       vector<size_t>& path) const {
+        if (!same_component(start, end) || !covers(allowed)) return false;
+        return findPathBreadthFirstIds(*this, start, end, context, path, allowed);
+    }
 
-            if (!visited[current]) {
-                visited[current] = true;
+    bool find_path_dfs(const string& start, const string& end, vector<string>& path, const Bitmap& allowed) const {
+        if (!same_component(start, end)) return false;
+        TraversalContextLease context;
+        vector<size_t>& ids = context->ids();
+        ids.clear();
+        if (!find_path_dfs(vertex_id(start), vertex_id(end), allowed, *context, ids)) return false;
+        append_titles(ids, path);
+        return true;
+    }
 
-                if (current == end) {
-                    string step = end;
-                    while (!step.empty()) {
-                        path.push_back(step);
-                        step = parent[step];
-                    }
-                    reverse(path.begin(), path.end());
-                    return true;
-                }
+    bool find_path_dfs(size_t start, size_t end, const Bitmap& allowed, TraversalContext& context,
+                       vector<size_t>& path) const {
+        if (!same_component(start, end) || !covers(allowed)) return false;
+        return findPathDepthFirstIds(*this, start, end, context, path, allowed);
+    }
 
-                for (const auto& neighbor : getNeighbors(current)) {
-                    if (!visited[neighbor.first]) {
-                        parent[neighbor.first] = current;
-                        s.push(neighbor.first);
-                    }
-                }
-            }
+    double calculate_path_distance(const vector<string>& path) const {
+        return calculatePathDistance(*this, path);
+    }
+
+    // Minimal-weight path between two movies (bidirectional Dijkstra, see
+    // ShortestPath.hpp). Fills `path` with the titles from start to end and
+    // `distance` with the sum of its edge weights; false if unreachable.
+    bool shortest_path(const string& start, const string& end, vector<string>& path, double& distance) const {
+        path.clear();
+        size_t source = vertex_id(start);
+        size_t target = vertex_id(end);
+        if (source == npos || target == npos) return false;
+        if (find_component(source) != find_component(target)) return false;
+
+        vector<size_t> ids;
+        if (!bidirectionalDijkstra(*this, source, target, ids, distance)) return false;
+        for (size_t v : ids) {
+            path.push_back(vertices_[v]);
         }
-        return false;
+        return true;
     }
 
-    double calculate_path_distance(const vector<string>& path) const {
-        double distance = 0.0;
-        for (size_t i = 1; i < path.size(); ++i) {
-            for (const auto& neighbor : getNeighbors(path[i - 1])) {
-                if (neighbor.first == path[i]) {
-                    distance += neighbor.second;
-                    break;
-                }
-            }
+    // Same as above with A* search guided by landmark lower bounds (see
+    // LandmarkOracle.hpp). If `landmarks` were built for another graph, or for
+    // this one before it was edited (LandmarkOracle::built_for compares
+    // fingerprints), falls back to bidirectional Dijkstra.
+    bool shortest_path(const string& start, const string& end, vector<string>& path, double& distance,
+                       const LandmarkOracle& landmarks) const {
+        path.clear();
+        size_t source = vertex_id(start);
+        size_t target = vertex_id(end);
+        if (source == npos || target == npos) return false;
+        if (find_component(source) != find_component(target)) return false;
+
+        vector<size_t> ids;
+        if (!altShortestPath(*this, landmarks, source, target, ids, distance)) return false;
+        for (size_t v : ids) {
+            path.push_back(vertices_[v]);
         }
-        return distance;
+        return true;
+    }
+
+    // Writes the graph as a binary graph file (see GraphFile.hpp) that
+    // MappedGraph can map and query without loading. Weights are stored as
+    // 16-bit codes, exact for up to 65536 distinct weights. Returns false if
+    // the file cannot be written.
+    bool save(const string& path) const {
+        return writeGraphFile(path, vertices_, adjacency_);
     }
 };
 